@@ -0,0 +1,32 @@
+//
+// Created by YthanZhang on 2026/10/19.
+//
+
+#ifndef PIUFED_BENCHMARK_H
+#define PIUFED_BENCHMARK_H
+
+
+#include <chrono>
+#include <cstdint>
+
+
+/**
+ * @brief Average wall time of one call of func(i), i counting from 0
+ */
+template <typename Func>
+static double nsPerCall(uint32_t calls, Func&& func)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < calls; ++i) { func(i); }
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() /
+           calls;
+}
+
+
+void simUARTBenchmark();
+void marginedLinearBenchmark();
+void marginedLinearBankBenchmark();
+
+
+#endif    // PIUFED_BENCHMARK_H
@@ -0,0 +1,15 @@
+//
+// Created by YthanZhang on 2026/10/19.
+//
+
+
+#include "benchmark.h"
+
+
+int main()
+{
+    simUARTBenchmark();
+    marginedLinearBenchmark();
+    marginedLinearBankBenchmark();
+    return 0;
+}
@@ -0,0 +1,143 @@
+//
+// Created by YthanZhang on 2026/10/19.
+//
+
+/*******************************************************************************
+ * Margined linear bank benchmark. @n
+ *
+ * 100k instances with random curves, one step is every instance taking a new
+ * input. Compares the loop over piu_MarginedLinear structs with one
+ * piu_MarginedLinearBank_update call, then splits the bank across 1 to
+ * hardware_concurrency persistent worker threads, thread start up is not
+ * part of the measured time.
+ */
+
+#include "benchmark.h"
+
+#include "piu_margined_linear_bank.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+
+static volatile uint32_t sink;
+
+
+void marginedLinearBankBenchmark()
+{
+    constexpr size_t count  = 100000;
+    constexpr uint32_t step = 16;
+
+    uint32_t seed = 3;
+    auto next     = [&]() {
+        seed = seed * 1103515245u + 12345u;
+        return (uint16_t)(seed >> 16);
+    };
+
+    std::vector<piu_MarginedLinear> structs;
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint16_t x[6];
+        for (uint16_t& v : x) { v = next(); }
+        std::sort(std::begin(x), std::end(x));
+        structs.push_back(piu_MarginedLinear_make(x[0], x[1], x[2], x[3], x[4],
+                                                  x[5], next(), next(), next(),
+                                                  next()));
+    }
+
+    std::vector<uint32_t> storage(PIU_MARGINED_LINEAR_BANK_WORDS(count));
+    piu_MarginedLinearBank bank;
+    piu_MarginedLinearBank_construct(&bank, storage.data(), count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        piu_MarginedLinearBank_setInstance(&bank, i, &structs[i]);
+    }
+
+    // A few input vectors reused round robin
+    std::vector<std::vector<uint16_t>> inputs(step,
+                                              std::vector<uint16_t>(count));
+    for (auto& in : inputs)
+    {
+        for (uint16_t& v : in) { v = next(); }
+    }
+    std::vector<uint16_t> out(count);
+
+    std::printf("Margined linear bank, %zu instances, %zu bytes vs %zu\n",
+                count,
+                storage.size() * sizeof(uint32_t),
+                structs.size() * sizeof(piu_MarginedLinear));
+
+    const double structNs = nsPerCall(step * 4, [&](uint32_t s) {
+        const auto& in = inputs[s % step];
+        for (size_t i = 0; i < count; ++i)
+        {
+            out[i] = piu_MarginedLinear_setX(&structs[i], in[i]);
+        }
+        sink = out[0];
+    });
+    std::printf("struct loop      %8.1f us/step\n", structNs / 1000);
+
+    const uint32_t cores = std::max(1u, std::thread::hardware_concurrency());
+    for (uint32_t threads = 1; threads <= cores; threads *= 2)
+    {
+        // Workers are started once and spin on a generation counter, only
+        // publishing the step and waiting for the ranges is timed. The
+        // calling thread updates range 0 itself.
+        std::atomic<uint32_t> generation{0};
+        std::atomic<uint32_t> finished{0};
+        std::atomic<bool> stop{false};
+        const uint16_t* stepInput = nullptr;
+
+        auto updateRange = [&](uint32_t t) {
+            piu_MarginedLinearBank_update(&bank, stepInput, out.data(),
+                                          count * t / threads,
+                                          count * (t + 1) / threads);
+        };
+
+        std::vector<std::thread> workers;
+        for (uint32_t t = 1; t < threads; ++t)
+        {
+            workers.emplace_back([&, t]() {
+                uint32_t seen = 0;
+                while (true)
+                {
+                    uint32_t current;
+                    while ((current = generation.load(
+                                std::memory_order_acquire)) == seen)
+                    {
+                        if (stop.load(std::memory_order_relaxed)) { return; }
+                        std::this_thread::yield();
+                    }
+                    seen = current;
+                    updateRange(t);
+                    finished.fetch_add(1, std::memory_order_release);
+                }
+            });
+        }
+
+        const double bankNs = nsPerCall(step * 4, [&](uint32_t s) {
+            stepInput = inputs[s % step].data();
+            finished.store(0, std::memory_order_relaxed);
+            generation.fetch_add(1, std::memory_order_release);
+
+            updateRange(0);
+            while (finished.load(std::memory_order_acquire) != threads - 1)
+            {
+                std::this_thread::yield();
+            }
+        });
+
+        stop.store(true, std::memory_order_relaxed);
+        for (auto& worker : workers) { worker.join(); }
+
+        sink = out[0];
+        std::printf("bank %2u threads  %8.1f us/step, %.1fx\n",
+                    threads,
+                    bankNs / 1000,
+                    structNs / bankNs);
+    }
+    std::printf("\n");
+}
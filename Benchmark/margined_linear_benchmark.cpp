@@ -0,0 +1,154 @@
+//
+// Created by YthanZhang on 2026/10/19.
+//
+
+/*******************************************************************************
+ * Margined linear per sample and batch evaluation benchmark. @n
+ *
+ * Runs the same input streams through piu_MarginedLinear_setX one sample at a
+ * time and through piu_MarginedLinear_setXBatch, reporting the cost per sample
+ * for a stream that stays in the linear section and for a random walk that
+ * keeps crossing the thresholds, with and without the lookup table. The
+ * piecewise hysteresis curve is timed at several breakpoint counts, with a
+ * walk that moves at most one segment per sample (neighbour step path) and
+ * with random jumps over the whole range (binary search path).
+ */
+
+#include "benchmark.h"
+
+#include "piu_margined_linear.h"
+#include "piu_piecewise_hysteresis.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+
+static volatile uint32_t sink;
+
+
+static std::vector<uint16_t> linearStream(size_t count)
+{
+    std::vector<uint16_t> in(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        in[i] = (uint16_t)(10000 + i % 30000);
+    }
+    return in;
+}
+
+static std::vector<uint16_t> randomWalk(size_t count, int32_t maxStep = 1000)
+{
+    std::vector<uint16_t> in(count);
+    uint32_t seed = 1;
+    int32_t pos   = 0;
+    for (uint16_t& v : in)
+    {
+        seed = seed * 1103515245u + 12345u;
+        pos += (int32_t)((seed >> 16) % (2 * maxStep + 1)) - maxStep;
+        pos = std::clamp(pos, 0, (int32_t)UINT16_MAX);
+        v   = (uint16_t)pos;
+    }
+    return in;
+}
+
+static void benchStream(const char* name, const std::vector<uint16_t>& in)
+{
+    constexpr uint32_t rounds = 200;
+    const double count        = (double)in.size();
+    std::vector<uint16_t> out(in.size());
+
+    auto single = piu_MarginedLinear_make(1000, 2000, 3000, 60000, 62000, 64000,
+                                          0, 100, 60000, 65535);
+    auto batch  = single;
+    auto lut    = single;
+
+    std::vector<uint16_t> table(piu_MarginedLinear_getLUTSize(&lut) /
+                                sizeof(uint16_t));
+    piu_MarginedLinear_setLUT(&lut, table.data(), table.size());
+
+    const double singleNs = nsPerCall(rounds, [&](uint32_t) {
+        for (size_t i = 0; i < in.size(); ++i)
+        {
+            out[i] = piu_MarginedLinear_setX(&single, in[i]);
+        }
+        sink = out.back();
+    });
+    const double batchNs  = nsPerCall(rounds, [&](uint32_t) {
+        piu_MarginedLinear_setXBatch(&batch, in.data(), out.data(), in.size());
+        sink = out.back();
+    });
+    const double lutNs    = nsPerCall(rounds, [&](uint32_t) {
+        piu_MarginedLinear_setXBatch(&lut, in.data(), out.data(), in.size());
+        sink = out.back();
+    });
+
+    std::printf("%-12s setX %6.2f, setXBatch %6.2f, LUT batch %6.2f "
+                "ns/sample\n",
+                name,
+                singleNs / count,
+                batchNs / count,
+                lutNs / count);
+}
+
+static std::vector<uint16_t> randomJumps(size_t count)
+{
+    std::vector<uint16_t> in(count);
+    uint32_t seed = 7;
+    for (uint16_t& v : in)
+    {
+        seed = seed * 1103515245u + 12345u;
+        v    = (uint16_t)(seed >> 16);
+    }
+    return in;
+}
+
+static void benchPiecewise(uint16_t segments)
+{
+    // Breakpoints spread over 1000 to 61000, y zigzags inside 0 to 63000
+    std::vector<piu_PiecewisePoint> points(segments);
+    const uint16_t width = (uint16_t)(60000 / segments);
+    for (uint16_t i = 0; i < segments; ++i)
+    {
+        const uint16_t level = (uint16_t)(i % 64 * 1000);
+        points[i].xRise      = (uint16_t)(1000 + i * width);
+        points[i].xFall      = (uint16_t)(points[i].xRise - width / 4);
+        points[i].y          = (i & 1) ? (uint16_t)(63000 - level) : level;
+    }
+    std::vector<piu_PiecewiseSegment> table(segments);
+    piu_PiecewiseHysteresis curve;
+    piu_PiecewiseHysteresis_construct(
+        &curve, points.data(), table.data(), segments);
+
+    // Steps under half a segment never skip one, jumps mostly do
+    const auto walk  = randomWalk(1 << 20, width / 2);
+    const auto jumps = randomJumps(1 << 20);
+
+    const double stepNs = nsPerCall(walk.size(), [&](uint32_t i) {
+        sink = piu_PiecewiseHysteresis_setX(&curve, walk[i]);
+    });
+    const double jumpNs = nsPerCall(jumps.size(), [&](uint32_t i) {
+        sink = piu_PiecewiseHysteresis_setX(&curve, jumps[i]);
+    });
+    std::printf("piecewise %4u breakpoints, neighbour step %6.2f, "
+                "binary search %6.2f ns/sample\n",
+                segments,
+                stepNs,
+                jumpNs);
+}
+
+
+void marginedLinearBenchmark()
+{
+    auto ml = piu_MarginedLinear_make(1000, 2000, 3000, 60000, 62000, 64000, 0,
+                                      100, 60000, 65535);
+    std::printf("Margined linear, LUT %zu bytes\n",
+                piu_MarginedLinear_getLUTSize(&ml));
+    benchStream("linear", linearStream(1 << 16));
+    benchStream("random walk", randomWalk(1 << 16));
+    for (uint16_t segments : {4, 12, 64, 1024})
+    {
+        benchPiecewise(segments);
+    }
+    std::printf("\n");
+}
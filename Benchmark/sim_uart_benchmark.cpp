@@ -0,0 +1,154 @@
+//
+// Created by YthanZhang on 2026/10/19.
+//
+
+/*******************************************************************************
+ * Sim UART throughput and error rate benchmark. @n
+ *
+ * Build with -DPIUFED_DoBenchmark=ON -DCMAKE_BUILD_TYPE=Release and run
+ * piufed-benchmark. Reports the per bit cost of the Tx, oversampled Rx and
+ * bank updates on one core, the resulting bits per second, and the byte error
+ * rate of the virtual wire under clock skew, jitter and noise.
+ */
+
+#include "benchmark.h"
+
+#include "piu_sim_uart.h"
+#include "piu_sim_uart_bank.h"
+#include "piu_sim_uart_wire.h"
+
+#include <cstdio>
+#include <vector>
+
+
+static void unusedTx(bool) {}
+
+static volatile uint32_t sink;
+
+
+static void benchThroughput()
+{
+    constexpr uint32_t calls = 20000000;
+    constexpr uint8_t ratio  = 16;
+
+    piu_SimUART uart;
+    volatile uint32_t port = 0;
+    uint8_t txStorage[256];
+    piu_SimUART_construct(&uart, unusedTx);
+    piu_SimUART_attachFifo(&uart, nullptr, 0, txStorage, 256);
+    piu_SimUART_setTxRegisters(&uart, &port, nullptr, 1);
+    piu_SimUART_setOversample(&uart, ratio);
+
+    const double txNs = nsPerCall(calls, [&](uint32_t i) {
+        if (piu_SimUART_getTxFree(&uart) != 0)
+        {
+            piu_SimUART_sendTx(&uart, (uint8_t)i);
+        }
+        piu_SimUART_txTIMUpdate(&uart);
+    });
+
+    // Rx fed with a continuous 0x55 pattern, 16 samples per bit
+    const double rxNs = nsPerCall(calls, [&](uint32_t i) {
+        const uint32_t bit = (i / ratio) % 10;
+        piu_SimUART_rxSampleUpdate(&uart, bit == 9 || (bit & 0x01));
+        sink = piu_SimUART_getRx(&uart);
+    });
+
+    std::printf("Single channel, one core\n");
+    std::printf("  Tx update       %7.2f ns/bit   %8.2f Mbit/s\n",
+                txNs, 1e3 / txNs);
+    std::printf("  Rx 16x sample   %7.2f ns/bit   %8.2f Mbit/s\n",
+                rxNs * ratio, 1e3 / (rxNs * ratio));
+    std::printf("  115200 baud full duplex channels per core: %.0f\n",
+                1e9 / ((txNs + rxNs * ratio) * 115200));
+
+    piu_SimUARTBank bank;
+    piu_SimUARTBank_construct(&bank, 0x0000FFFF, 0xFFFF0000, ratio);
+    uint32_t txWord   = 0xFFFF0000;
+    const double bankNs = nsPerCall(calls, [&](uint32_t i) {
+        if ((i & 0xFF) == 0)
+        {
+            for (uint8_t ch = 16; ch < 32; ++ch)
+            {
+                piu_SimUARTBank_sendTx(&bank, ch, (uint8_t)(i >> 8));
+            }
+        }
+        txWord = piu_SimUARTBank_update(&bank, txWord >> 16);
+    });
+    sink = txWord;
+
+    std::printf("Bank of 16 Rx + 16 Tx channels, one core\n");
+    std::printf("  Bank update     %7.2f ns/update %8.2f Mbit/s total\n",
+                bankNs, 32 * 1e3 / (bankNs * ratio));
+}
+
+
+static double byteErrorRate(int32_t skewPpm,
+                            uint16_t jitterPermille,
+                            uint16_t noise,
+                            uint32_t count)
+{
+    piu_SimUART txUART;
+    piu_SimUART rxUART;
+    uint8_t txStorage[64];
+    uint8_t rxStorage[64];
+    piu_SimUART_construct(&txUART, unusedTx);
+    piu_SimUART_construct(&rxUART, unusedTx);
+    piu_SimUART_attachFifo(&txUART, nullptr, 0, txStorage, 64);
+    piu_SimUART_attachFifo(&rxUART, rxStorage, 64, nullptr, 0);
+
+    piu_SimUARTWire wire;
+    piu_SimUARTWire_construct(
+        &wire, &txUART, &rxUART, skewPpm, jitterPermille, noise, 12345);
+    piu_SimUARTWire_run(&wire, 4);
+
+    uint32_t errors = 0;
+    for (uint32_t sent = 0; sent < count; sent += 32)
+    {
+        for (uint32_t i = 0; i < 32; ++i)
+        {
+            piu_SimUART_sendTx(&txUART, (uint8_t)((sent + i) * 97));
+        }
+        piu_SimUARTWire_run(&wire, 32 * 10 + 4);
+
+        uint32_t received = 0;
+        while (piu_SimUART_getRxCount(&rxUART) != 0)
+        {
+            uint8_t val = piu_SimUART_getRx(&rxUART);
+            errors += received >= 32 || val != (uint8_t)((sent + received) * 97);
+            ++received;
+        }
+        errors += received < 32 ? 32 - received : 0;
+
+        // Resynchronize on an idle line before the next burst
+        piu_SimUARTWire_run(&wire, 20);
+        piu_SimUART_getRx(&rxUART);
+    }
+    return (double)errors / count;
+}
+
+static void benchErrorRate()
+{
+    const int32_t skews[]     = {0, -10000, -20000, -30000, -40000, -50000};
+    const uint16_t noises[]   = {0, 655, 3277};    // 0%, 1%, 5% of samples
+    constexpr uint32_t count  = 4096;
+
+    std::printf("\nByte error rate, 16x Rx, 10%% jitter, %u bytes\n", count);
+    std::printf("  Rx skew   noise 0%%   noise 1%%   noise 5%%\n");
+    for (int32_t skew : skews)
+    {
+        std::printf("  %+5.1f%%", skew / 1e4);
+        for (uint16_t noise : noises)
+        {
+            std::printf("   %8.5f", byteErrorRate(skew, 100, noise, count));
+        }
+        std::printf("\n");
+    }
+}
+
+
+void simUARTBenchmark()
+{
+    benchThroughput();
+    benchErrorRate();
+}
@@ -0,0 +1,165 @@
+//
+// Created by YthanZhang on 2026/10/19.
+//
+
+#include "piu_atomic_vtimer.h"
+
+#include "catch2/catch_all.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+
+static std::atomic<uint32_t> callbackCount {0};
+static void countingCallback() { callbackCount.fetch_add(1); }
+
+
+TEST_CASE("Atomic virtual timer test", "[atomic_vtimer]")
+{
+    piu_AtomicVTimer vtimer;
+    piu_AtomicVTimer_construct(&vtimer, 3, piu_VTMode_OneShot, nullptr);
+
+    SECTION("basic oneshot overflow test")
+    {
+        piu_AtomicVTimer_startCounter(&vtimer);
+
+        piu_AtomicVTimer_tick(&vtimer);    // 1
+        REQUIRE(piu_AtomicVTimer_getCounter(&vtimer) == 1);
+
+        piu_AtomicVTimer_tick(&vtimer);    // 2
+        piu_AtomicVTimer_tick(&vtimer);    // 3
+        REQUIRE(piu_AtomicVTimer_getCounter(&vtimer) == 3);
+
+        piu_AtomicVTimer_tick(&vtimer);    // overflow
+        REQUIRE(piu_AtomicVTimer_getCounter(&vtimer) == 0);
+        REQUIRE(piu_AtomicVTimer_getOverflow(&vtimer));
+        REQUIRE_FALSE(piu_AtomicVTimer_getOverflow(&vtimer));
+        REQUIRE_FALSE(piu_AtomicVTimer_getOverOverflow(&vtimer));
+        REQUIRE_FALSE(piu_AtomicVTimer_getCounterActive(&vtimer));
+
+        piu_AtomicVTimer_tick(&vtimer);    // oneshot should not tick
+        REQUIRE(piu_AtomicVTimer_getCounter(&vtimer) == 0);
+    }
+
+    SECTION("over overflow test")
+    {
+        piu_AtomicVTimer_setTimerMode(&vtimer, piu_VTMode_Continuous);
+        piu_AtomicVTimer_startCounter(&vtimer);
+
+        for (uint8_t i = 0; i < 8; ++i) { piu_AtomicVTimer_tick(&vtimer); }
+
+        REQUIRE(piu_AtomicVTimer_getOverflow(&vtimer));
+        REQUIRE(piu_AtomicVTimer_getOverOverflow(&vtimer));
+        REQUIRE(piu_AtomicVTimer_clearOverOverflow(&vtimer));
+        REQUIRE_FALSE(piu_AtomicVTimer_getOverOverflow(&vtimer));
+        REQUIRE(piu_AtomicVTimer_getCounter(&vtimer) == 0);
+    }
+
+    SECTION("static make test")
+    {
+        piu_AtomicVTimer made =
+            PIU_ATOMIC_VTIMER_MAKE(3, piu_VTMode_Continuous, nullptr);
+        REQUIRE(piu_AtomicVTimer_getCounterReloadValue(&made) == 3);
+
+        piu_AtomicVTimer_startCounter(&made);
+        for (uint8_t i = 0; i < 5; ++i) { piu_AtomicVTimer_tick(&made); }
+        REQUIRE(piu_AtomicVTimer_getCounterActive(&made));
+        REQUIRE(piu_AtomicVTimer_getCounter(&made) == 1);
+    }
+}
+
+
+TEST_CASE("Atomic virtual timer stress test", "[atomic_vtimer]")
+{
+    constexpr uint32_t tickCount = 200000;
+    constexpr uint16_t reload    = 3;
+
+    piu_AtomicVTimer vtimer;
+    piu_AtomicVTimer_construct(&vtimer,
+                               reload,
+                               piu_VTMode_Continuous,
+                               countingCallback);
+    callbackCount = 0;
+
+    SECTION("no overflow is lost or reported twice")
+    {
+        piu_AtomicVTimer_startCounter(&vtimer);
+
+        std::atomic<bool> done {false};
+        std::atomic<uint32_t> observed {0};
+
+        std::vector<std::thread> pollers;
+        for (int i = 0; i < 3; ++i)
+        {
+            pollers.emplace_back([&]() {
+                while (!done.load())
+                {
+                    if (piu_AtomicVTimer_getOverflow(&vtimer))
+                    {
+                        observed.fetch_add(1);
+                    }
+                    piu_AtomicVTimer_clearOverOverflow(&vtimer);
+                }
+            });
+        }
+
+        std::thread ticker([&]() {
+            for (uint32_t i = 0; i < tickCount; ++i)
+            {
+                piu_AtomicVTimer_tick(&vtimer);
+            }
+            done = true;
+        });
+
+        ticker.join();
+        for (auto& poller : pollers) { poller.join(); }
+
+        if (piu_AtomicVTimer_getOverflow(&vtimer))
+        {
+            observed.fetch_add(1);
+        }
+
+        // counter must never have been corrupted by the pollers
+        REQUIRE(callbackCount.load() == tickCount / (reload + 1));
+        REQUIRE(observed.load() <= callbackCount.load());
+        REQUIRE(observed.load() > 0);
+    }
+
+    SECTION("start stop and reset race with tick")
+    {
+        std::atomic<bool> done {false};
+        std::atomic<bool> counterInRange {true};
+
+        std::thread worker([&]() {
+            uint32_t i = 0;
+            while (!done.load())
+            {
+                switch (i++ % 3)
+                {
+                case 0: piu_AtomicVTimer_startCounter(&vtimer); break;
+                case 1: piu_AtomicVTimer_stopCounter(&vtimer); break;
+                default: piu_AtomicVTimer_resetCounter(&vtimer); break;
+                }
+            }
+        });
+
+        std::thread ticker([&]() {
+            for (uint32_t i = 0; i < tickCount; ++i)
+            {
+                piu_AtomicVTimer_tick(&vtimer);
+                if (piu_AtomicVTimer_getCounter(&vtimer) > reload)
+                {
+                    counterInRange = false;
+                }
+            }
+            done = true;
+        });
+
+        ticker.join();
+        worker.join();
+
+        REQUIRE(counterInRange.load());
+        REQUIRE(callbackCount.load() <= tickCount / (reload + 1));
+    }
+}
@@ -0,0 +1,125 @@
+//
+// Created by YthanZhang on 2026/10/19.
+//
+
+
+#include "piu_margined_linear_bank.h"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "catch2/catch_all.hpp"
+
+
+TEST_CASE("Margined linear bank test", "[MarginedLinearBank]")
+{
+    constexpr size_t count = 1000;
+
+    // Random curves, rising and falling, some degenerate
+    std::vector<piu_MarginedLinear> structs;
+    uint32_t seed = 7;
+    auto next     = [&]() {
+        seed = seed * 1103515245u + 12345u;
+        return (uint16_t)(seed >> 16);
+    };
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint16_t x[6];
+        for (uint16_t& v : x) { v = next(); }
+        std::sort(std::begin(x), std::end(x));
+        structs.push_back(piu_MarginedLinear_make(x[0], x[1], x[2], x[3], x[4],
+                                                  x[5], next(), next(), next(),
+                                                  next()));
+    }
+    structs[0] = piu_MarginedLinear_make(0, 0, 0, 0, 0, 0, 1, 2, 3, 4);
+    structs[1] = piu_MarginedLinear_make(5, 5, 5, 65535, 65535, 65535, 0, 0,
+                                         65535, 65535);
+
+    std::vector<uint32_t> storage(PIU_MARGINED_LINEAR_BANK_WORDS(count));
+    piu_MarginedLinearBank bank;
+    piu_MarginedLinearBank_construct(&bank, storage.data(), count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        piu_MarginedLinearBank_setInstance(&bank, i, &structs[i]);
+    }
+
+    const size_t threads = GENERATE(1, 3);
+
+    std::vector<uint16_t> in(count), out(count);
+    for (int step = 0; step < 200; ++step)
+    {
+        // Mix of small moves and large jumps
+        for (size_t i = 0; i < count; ++i)
+        {
+            in[i] = step % 10 == 0 ? next()
+                                   : (uint16_t)(structs[i].lastInput +
+                                                (next() % 4001) - 2000);
+        }
+
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < threads; ++t)
+        {
+            workers.emplace_back([&, t]() {
+                piu_MarginedLinearBank_update(&bank, in.data(), out.data(),
+                                              count * t / threads,
+                                              count * (t + 1) / threads);
+            });
+        }
+        for (auto& worker : workers) { worker.join(); }
+
+        std::vector<uint16_t> expect(count);
+        std::vector<piu_MarginSection> states(count), expectStates(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            expect[i]       = piu_MarginedLinear_setX(&structs[i], in[i]);
+            expectStates[i] = structs[i].currentState;
+            states[i]       = piu_MarginedLinearBank_getState(&bank, i);
+        }
+        REQUIRE(out == expect);
+        REQUIRE(states == expectStates);
+    }
+}
+
+
+TEST_CASE("Margined linear bank empty linear section test",
+          "[MarginedLinearBank]")
+{
+    // calcLinear gives an infinite or NaN slope for these, the bank must not
+    // convert it, checked with -fsanitize=undefined,float-cast-overflow
+    std::vector<piu_MarginedLinear> structs = {
+        piu_MarginedLinear_make(0, 0, 0, 0, 0, 0, 1, 2, 3, 4),
+        piu_MarginedLinear_make(7, 7, 7, 7, 7, 7, 1, 65535, 0, 4),
+        piu_MarginedLinear_make(100, 200, 300, 300, 400, 500, 0, 0, 0, 0),
+        piu_MarginedLinear_make(10, 20, 65535, 65535, 65535, 65535, 5, 6, 60000,
+                                8),
+    };
+    const size_t count = structs.size();
+
+    std::vector<uint32_t> storage(PIU_MARGINED_LINEAR_BANK_WORDS(count));
+    piu_MarginedLinearBank bank;
+    piu_MarginedLinearBank_construct(&bank, storage.data(), count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        piu_MarginedLinearBank_setInstance(&bank, i, &structs[i]);
+        REQUIRE(bank.linearRate[i] == 0);
+    }
+
+    // Up and back down through every threshold
+    std::vector<uint16_t> in(count), out(count), expect(count);
+    for (uint32_t step = 0; step < 2 * 65536; ++step)
+    {
+        const uint16_t x = (uint16_t)(step < 65536 ? step : 131071 - step);
+        for (size_t i = 0; i < count; ++i)
+        {
+            in[i]     = x;
+            expect[i] = piu_MarginedLinear_setX(&structs[i], x);
+        }
+        piu_MarginedLinearBank_update(&bank, in.data(), out.data(), 0, count);
+        if (out != expect)    // REQUIRE per step is slow
+        {
+            REQUIRE(out == expect);
+        }
+    }
+    REQUIRE(out == expect);
+}
@@ -0,0 +1,80 @@
+//
+// Created by YthanZhang on 2026/10/19.
+//
+
+
+#include "piu_margined_linear.hpp"
+
+#include "catch2/catch_all.hpp"
+
+
+using FanCurve = piu::MarginedLinearCurve<5243, 6553, 6554, 62258, 62258,
+                                          62258, 0, 6554, 65535, 65535>;
+using FallingCurve = piu::MarginedLinearCurve<100, 200, 300, 40000, 41000,
+                                              42000, 10, 60000, 20, 65535>;
+using FlatCurve    = piu::MarginedLinearCurve<7, 7, 7, 7, 7, 7, 1, 2, 3, 4>;
+
+
+// Evaluated by the compiler
+static constexpr uint16_t rampTo(uint16_t x)
+{
+    piu_MarginSection section = piu_MarginState_Off;
+    return FanCurve::setX(section, x);
+}
+static_assert(rampTo(0) == 0);
+static_assert(rampTo(6553) == 0);
+static_assert(rampTo(6554) == 6554);
+static_assert(rampTo(6555) == 6555);
+static_assert(rampTo(62259) == 65535);
+static_assert(FanCurve::marginedLinear.xStepUp == 62258);
+static_assert(FallingCurve::linearFalling);
+
+
+template <typename Curve>
+static void requireSameAsRuntime()
+{
+    const auto& c = Curve::marginedLinear;
+    auto runtime  = piu_MarginedLinear_make(c.xOff, c.xOn, c.xLinearLow,
+                                            c.xLinearHigh, c.xStepDown,
+                                            c.xStepUp, c.yOff, c.yLowFlat,
+                                            c.yHighFlat, c.yMaxFlat);
+
+    REQUIRE(runtime.currentState == c.currentState);
+    REQUIRE(runtime.lastInput == c.lastInput);
+    REQUIRE(runtime.linearRateQ16 == c.linearRateQ16);
+    REQUIRE(runtime.flag_linearFalling == c.flag_linearFalling);
+    if (c.xLinearLow != c.xLinearHigh)
+    {
+        REQUIRE(runtime.linearRate == c.linearRate);
+    }
+
+    // Every input from every section
+    for (uint32_t s = piu_MarginState_Off; s <= piu_MarginState_MaxFlat; ++s)
+    {
+        for (uint32_t x = 0; x <= UINT16_MAX; ++x)
+        {
+            auto section         = (piu_MarginSection)s;
+            runtime.currentState = section;
+
+            const uint16_t y = Curve::setX(section, (uint16_t)x);
+            if (y != piu_MarginedLinear_setX(&runtime, (uint16_t)x) ||
+                section != runtime.currentState)    // REQUIRE is slow
+            {
+                REQUIRE(y == piu_MarginedLinear_getY(&runtime));
+                REQUIRE(section == runtime.currentState);
+            }
+        }
+    }
+
+    // The constexpr struct works with the C API
+    auto copy = c;
+    REQUIRE(piu_MarginedLinear_setX(&copy, c.xStepUp + 1u) == c.yMaxFlat);
+}
+
+
+TEST_CASE("Margined linear constexpr test", "[MarginedLinear]")
+{
+    requireSameAsRuntime<FanCurve>();
+    requireSameAsRuntime<FallingCurve>();
+    requireSameAsRuntime<FlatCurve>();
+}
@@ -4,10 +4,64 @@
 
 
 #include "piu_margined_linear.h"
+#include "piu_modbus_crc16.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
 
 #include "catch2/catch_all.hpp"
 
 
+// The original one transition at a time state machine
+static piu_MarginSection referenceState(const piu_MarginedLinear& ml,
+                                        piu_MarginSection state,
+                                        uint16_t x)
+{
+    while (true)
+    {
+        switch (state)
+        {
+        case piu_MarginState_Off:
+            if (x > ml.xOn) { state = piu_MarginState_LowFlat; continue; }
+            break;
+        case piu_MarginState_LowFlat:
+            if (x > ml.xLinearLow) { state = piu_MarginState_Linear; continue; }
+            if (x <= ml.xOff) { state = piu_MarginState_Off; continue; }
+            break;
+        case piu_MarginState_Linear:
+            if (x > ml.xLinearHigh)
+            {
+                state = piu_MarginState_HighFlat;
+                continue;
+            }
+            if (x <= ml.xLinearLow)
+            {
+                state = piu_MarginState_LowFlat;
+                continue;
+            }
+            break;
+        case piu_MarginState_HighFlat:
+            if (x > ml.xStepUp) { state = piu_MarginState_MaxFlat; continue; }
+            if (x <= ml.xLinearHigh)
+            {
+                state = piu_MarginState_Linear;
+                continue;
+            }
+            break;
+        case piu_MarginState_MaxFlat:
+            if (x <= ml.xStepDown)
+            {
+                state = piu_MarginState_HighFlat;
+                continue;
+            }
+            break;
+        }
+        return state;
+    }
+}
+
+
 TEST_CASE("Margined linear function test", "[MarginedLinear]")
 {
     auto ml =
@@ -57,3 +111,292 @@ TEST_CASE("Margined linear function test", "[MarginedLinear]")
         REQUIRE(std::round((float)6553 * 2000.0f / (float)UINT16_MAX) == 200.0f);
     }
 }
+
+
+TEST_CASE("Margined linear fixed point test", "[MarginedLinear]")
+{
+    struct Config
+    {
+        uint16_t x[6];
+        uint16_t y[4];
+    };
+    const Config configs[] = {
+        {{5243, 6553, 6554, 62258, 62258, 62258}, {0, 6554, 65535, 65535}},
+        {{100, 200, 300, 301, 400, 500}, {0, 10, 65535, 65535}},
+        {{100, 200, 300, 40000, 41000, 42000}, {0, 60000, 7, 9}},
+        {{0, 0, 0, 65535, 65535, 65535}, {0, 0, 65535, 65535}},
+        {{10, 20, 1000, 3000, 4000, 5000}, {1, 333, 334, 400}},
+    };
+
+    for (const Config& c : configs)
+    {
+        auto ml = piu_MarginedLinear_make(c.x[0], c.x[1], c.x[2], c.x[3],
+                                          c.x[4], c.x[5], c.y[0], c.y[1],
+                                          c.y[2], c.y[3]);
+
+        for (uint32_t x = 0; x <= UINT16_MAX; ++x)
+        {
+            int32_t y      = piu_MarginedLinear_setX(&ml, (uint16_t)x);
+            int32_t yFixed = piu_MarginedLinear_getYFixed(&ml);
+            if (std::abs(y - yFixed) > 1)    // REQUIRE per sample is slow
+            {
+                REQUIRE(y == yFixed);
+            }
+        }
+        REQUIRE(piu_MarginedLinear_getYFixed(&ml) ==
+                piu_MarginedLinear_getY(&ml));
+    }
+
+    // Slope follows remapY
+    auto ml = piu_MarginedLinear_make(0, 0, 0, 1000, 1000, 1000, 0, 0, 1000,
+                                      1000);
+    REQUIRE(piu_MarginedLinear_setX(&ml, 500) == 500);
+    REQUIRE(piu_MarginedLinear_remapY(&ml, 0, 1000, 0, 2000));
+    REQUIRE(piu_MarginedLinear_setX(&ml, 500) == 1000);
+    REQUIRE(piu_MarginedLinear_getYFixed(&ml) == 1000);
+}
+
+
+TEST_CASE("Margined linear batch test", "[MarginedLinear]")
+{
+    const uint16_t x[6] = {1000, 2000, 3000, 40000, 50000, 60000};
+    const uint16_t y[4] = {0, 100, 60000, 65535};
+
+    auto single = piu_MarginedLinear_make(x[0], x[1], x[2], x[3], x[4], x[5],
+                                          y[0], y[1], y[2], y[3]);
+    auto batch  = single;
+
+    // Random walk that crosses every threshold in both directions
+    std::vector<uint16_t> in(20000);
+    uint32_t seed = 12345;
+    int32_t pos   = 0;
+    for (uint16_t& v : in)
+    {
+        seed = seed * 1103515245u + 12345u;
+        pos += (int32_t)((seed >> 16) % 2001) - 1000;
+        pos = std::clamp(pos, 0, (int32_t)UINT16_MAX);
+        v   = (uint16_t)pos;
+    }
+
+    std::vector<uint16_t> expect(in.size());
+    for (size_t i = 0; i < in.size(); ++i)
+    {
+        expect[i] = piu_MarginedLinear_setX(&single, in[i]);
+    }
+
+    // Uneven chunks, state carries over between calls
+    std::vector<uint16_t> out(in.size());
+    const size_t chunk = GENERATE(1, 7, 256, 20000);
+    for (size_t i = 0; i < in.size(); i += chunk)
+    {
+        piu_MarginedLinear_setXBatch(&batch, in.data() + i, out.data() + i,
+                                     std::min(chunk, in.size() - i));
+    }
+    REQUIRE(out == expect);
+    REQUIRE(batch.currentState == single.currentState);
+    REQUIRE(piu_MarginedLinear_getY(&batch) ==
+            piu_MarginedLinear_getY(&single));
+
+    // In place
+    auto inPlace = piu_MarginedLinear_make(x[0], x[1], x[2], x[3], x[4], x[5],
+                                           y[0], y[1], y[2], y[3]);
+    piu_MarginedLinear_setXBatch(&inPlace, in.data(), in.data(), in.size());
+    REQUIRE(in == expect);
+
+    piu_MarginedLinear_setXBatch(&inPlace, nullptr, nullptr, 0);
+    REQUIRE(piu_MarginedLinear_getY(&inPlace) == expect.back());
+}
+
+
+TEST_CASE("Margined linear LUT test", "[MarginedLinear]")
+{
+    auto plain = piu_MarginedLinear_make(100, 200, 300, 1300, 2000, 2100, 0,
+                                         10, 60000, 65535);
+    auto lut   = plain;
+
+    std::vector<uint16_t> table(1000);
+    REQUIRE(piu_MarginedLinear_getLUTSize(&lut) == 1000 * sizeof(uint16_t));
+    REQUIRE(piu_MarginedLinear_setLUT(&lut, table.data(), table.size()));
+    REQUIRE(lut.lutCount == 1000);
+
+    auto sweep = [&]() {
+        for (uint32_t x = 0; x <= 2200; ++x)
+        {
+            REQUIRE(piu_MarginedLinear_setX(&lut, (uint16_t)x) ==
+                    piu_MarginedLinear_setX(&plain, (uint16_t)x));
+        }
+        for (uint32_t x = 2200; x-- > 0;)
+        {
+            REQUIRE(piu_MarginedLinear_setX(&lut, (uint16_t)x) ==
+                    piu_MarginedLinear_setX(&plain, (uint16_t)x));
+        }
+    };
+    sweep();
+
+    SECTION("Rebuilt after update")
+    {
+        piu_MarginedLinear_updateOutput(&lut, 0, 60000, 5, 65535);
+        piu_MarginedLinear_updateOutput(&plain, 0, 60000, 5, 65535);
+        REQUIRE(lut.flag_lutDirty);
+        sweep();
+        REQUIRE_FALSE(lut.flag_lutDirty);
+
+        piu_MarginedLinear_updateXLinearHigh(&lut, 800);
+        piu_MarginedLinear_updateXLinearHigh(&plain, 800);
+        sweep();
+        REQUIRE(lut.lutCount == 500);
+    }
+
+    SECTION("Flat linear section needs no table")
+    {
+        piu_MarginedLinear_updateYHighFlat(&lut, 10);
+        piu_MarginedLinear_updateYHighFlat(&plain, 10);
+        REQUIRE(piu_MarginedLinear_getLUTSize(&lut) == 0);
+        sweep();
+        REQUIRE(lut.lutCount == 0);
+    }
+
+    SECTION("Shallow linear section is stored as steps")
+    {
+        // 1000 inputs with 10 or 11 distinct outputs
+        const uint16_t yHigh = GENERATE(20, 0);
+        piu_MarginedLinear_updateYHighFlat(&lut, yHigh);
+        piu_MarginedLinear_updateYHighFlat(&plain, yHigh);
+        REQUIRE(piu_MarginedLinear_getLUTSize(&lut) == 10 * sizeof(uint16_t));
+        REQUIRE(piu_MarginedLinear_setLUT(&lut, table.data(), 10));
+        REQUIRE(lut.flag_lutSteps);
+        REQUIRE(lut.lutCount <= 10);
+        sweep();
+
+        std::vector<uint16_t> in(2200), outLUT(2200), outPlain(2200);
+        for (size_t i = 0; i < in.size(); ++i) { in[i] = (uint16_t)i; }
+        piu_MarginedLinear_setXBatch(&lut, in.data(), outLUT.data(), 2200);
+        piu_MarginedLinear_setXBatch(&plain, in.data(), outPlain.data(), 2200);
+        REQUIRE(outLUT == outPlain);
+
+        REQUIRE_FALSE(piu_MarginedLinear_setLUT(&lut, table.data(), 9));
+        sweep();
+    }
+
+    SECTION("Too large falls back to arithmetic")
+    {
+        piu_MarginedLinear_updateXLinearHigh(&lut, 2000);
+        piu_MarginedLinear_updateXLinearHigh(&plain, 2000);
+        REQUIRE(piu_MarginedLinear_getLUTSize(&lut) > table.size() * 2);
+        REQUIRE_FALSE(
+            piu_MarginedLinear_setLUT(&lut, table.data(), table.size()));
+        sweep();
+        REQUIRE(lut.lutCount == 0);
+    }
+
+    SECTION("Batch")
+    {
+        std::vector<uint16_t> in(2200), outLUT(2200), outPlain(2200);
+        for (size_t i = 0; i < in.size(); ++i) { in[i] = (uint16_t)i; }
+        piu_MarginedLinear_setXBatch(&lut, in.data(), outLUT.data(), 2200);
+        piu_MarginedLinear_setXBatch(&plain, in.data(), outPlain.data(), 2200);
+        REQUIRE(outLUT == outPlain);
+    }
+
+    REQUIRE_FALSE(piu_MarginedLinear_setLUT(&lut, nullptr, 0));
+    sweep();
+}
+
+
+TEST_CASE("Margined linear branchless transition test", "[MarginedLinear]")
+{
+    auto ml = GENERATE(
+        piu_MarginedLinear_make(
+            5243, 6553, 6554, 62258, 62258, 62258, 0, 6554, 65535, 65535),
+        piu_MarginedLinear_make(
+            100, 200, 300, 40000, 41000, 42000, 10, 20, 60000, 65535),
+        piu_MarginedLinear_make(0, 0, 0, 65535, 65535, 65535, 0, 0, 65535, 1),
+        piu_MarginedLinear_make(7, 7, 7, 7, 7, 7, 1, 2, 3, 4),
+        piu_MarginedLinear_make(
+            1, 65534, 65534, 65534, 65535, 65535, 9, 8, 7, 6));
+
+    // Every input from every state
+    for (uint32_t s = piu_MarginState_Off; s <= piu_MarginState_MaxFlat; ++s)
+    {
+        for (uint32_t x = 0; x <= UINT16_MAX; ++x)
+        {
+            const auto state  = (piu_MarginSection)s;
+            const auto expect = referenceState(ml, state, (uint16_t)x);
+
+            auto ref         = ml;
+            ref.currentState = expect;
+            ref.lastInput    = (uint16_t)x;
+
+            ml.currentState = state;
+            const uint16_t y = piu_MarginedLinear_setX(&ml, (uint16_t)x);
+            if (ml.currentState != expect ||
+                y != piu_MarginedLinear_getY(&ref))    // REQUIRE is slow
+            {
+                REQUIRE(ml.currentState == expect);
+                REQUIRE(y == piu_MarginedLinear_getY(&ref));
+            }
+        }
+    }
+
+    ml.currentState = (piu_MarginSection)7;
+    REQUIRE(piu_MarginedLinear_setX(&ml, 65535) == ml.yOff);
+    REQUIRE(ml.currentState == piu_MarginState_Off);
+}
+
+
+TEST_CASE("Margined linear serialization test", "[MarginedLinear]")
+{
+    auto ml = piu_MarginedLinear_make(0x0102, 0x0304, 0x0506, 0x0708, 0x090A,
+                                      0x0B0C, 0x1111, 0x2222, 0x3333, 0x4444);
+    uint8_t blob[PIU_MARGINED_LINEAR_BLOB_SIZE];
+    REQUIRE(piu_MarginedLinear_serialize(&ml, blob) == sizeof(blob));
+
+    // Version, little endian values, CRC low byte first
+    REQUIRE(blob[0] == PIU_MARGINED_LINEAR_BLOB_VERSION);
+    REQUIRE(blob[1] == 0x02);
+    REQUIRE(blob[2] == 0x01);
+    REQUIRE(blob[11] == 0x0C);
+    REQUIRE(blob[12] == 0x0B);
+    REQUIRE(blob[20] == 0x44);
+    const uint16_t crc = piu_modbus_crc16(blob, sizeof(blob) - 2);
+    REQUIRE(blob[21] == (crc & 0xFF));
+    REQUIRE(blob[22] == (crc >> 8));
+
+    piu_MarginedLinear loaded;
+    REQUIRE(piu_MarginedLinear_deserialize(&loaded, blob, sizeof(blob)));
+    REQUIRE(std::memcmp(&loaded.xOff, &ml.xOff, 20) == 0);
+    REQUIRE(loaded.linearRate == ml.linearRate);
+    REQUIRE(loaded.linearRateQ16 == ml.linearRateQ16);
+    REQUIRE(loaded.flag_linearFalling == ml.flag_linearFalling);
+    REQUIRE(loaded.currentState == ml.currentState);
+    REQUIRE(loaded.lastInput == ml.lastInput);
+    for (uint32_t x = 0; x < 0x0C00; x += 7)
+    {
+        REQUIRE(piu_MarginedLinear_setX(&loaded, (uint16_t)x) ==
+                piu_MarginedLinear_setX(&ml, (uint16_t)x));
+    }
+
+    SECTION("Invalid blobs leave the struct untouched")
+    {
+        auto before = loaded;
+
+        const size_t index = GENERATE(0, 5, 20, 22);
+        blob[index] ^= 0x10;
+        REQUIRE_FALSE(
+            piu_MarginedLinear_deserialize(&loaded, blob, sizeof(blob)));
+        blob[index] ^= 0x10;
+
+        REQUIRE_FALSE(
+            piu_MarginedLinear_deserialize(&loaded, blob, sizeof(blob) - 1));
+
+        // Out of order x with a valid CRC
+        blob[4] = 0xFF;
+        const uint16_t badCrc = piu_modbus_crc16(blob, sizeof(blob) - 2);
+        blob[21]              = (uint8_t)badCrc;
+        blob[22]              = (uint8_t)(badCrc >> 8);
+        REQUIRE_FALSE(
+            piu_MarginedLinear_deserialize(&loaded, blob, sizeof(blob)));
+
+        REQUIRE(std::memcmp(&before, &loaded, sizeof(loaded)) == 0);
+    }
+}
@@ -0,0 +1,80 @@
+//
+// Created by YthanZhang on 2026/10/19.
+//
+
+
+#include "piu_output_limiter.h"
+#include "piu_margined_linear.h"
+
+#include "catch2/catch_all.hpp"
+
+
+TEST_CASE("Output limiter test", "[OutputLimiter]")
+{
+    piu_OutputLimiter limiter = PIU_OUTPUT_LIMITER_MAKE(100, 10, 1000);
+    REQUIRE(piu_OutputLimiter_getOutput(&limiter) == 1000);
+    REQUIRE_FALSE(piu_OutputLimiter_getChanged(&limiter));
+
+    SECTION("Deadband")
+    {
+        REQUIRE_FALSE(piu_OutputLimiter_setTarget(&limiter, 1010));
+        REQUIRE_FALSE(piu_OutputLimiter_setTarget(&limiter, 990));
+        REQUIRE(piu_OutputLimiter_tick(&limiter) == 1000);
+        REQUIRE_FALSE(piu_OutputLimiter_getChanged(&limiter));
+
+        REQUIRE(piu_OutputLimiter_setTarget(&limiter, 1011));
+        REQUIRE(piu_OutputLimiter_tick(&limiter) == 1011);
+        REQUIRE(piu_OutputLimiter_getChanged(&limiter));
+        REQUIRE_FALSE(piu_OutputLimiter_getChanged(&limiter));
+
+        // Full off is always reachable
+        piu_OutputLimiter_construct(&limiter, 0, 10, 5);
+        REQUIRE(piu_OutputLimiter_update(&limiter, 0) == 0);
+        piu_OutputLimiter_construct(&limiter, 0, 10, UINT16_MAX - 3);
+        REQUIRE(piu_OutputLimiter_update(&limiter, UINT16_MAX) == UINT16_MAX);
+    }
+
+    SECTION("Slew rate")
+    {
+        REQUIRE(piu_OutputLimiter_setTarget(&limiter, 1250));
+        REQUIRE(piu_OutputLimiter_tick(&limiter) == 1100);
+        REQUIRE(piu_OutputLimiter_tick(&limiter) == 1200);
+        REQUIRE(piu_OutputLimiter_tick(&limiter) == 1250);
+        REQUIRE(piu_OutputLimiter_getChanged(&limiter));
+        REQUIRE(piu_OutputLimiter_tick(&limiter) == 1250);
+        REQUIRE_FALSE(piu_OutputLimiter_getChanged(&limiter));
+
+        REQUIRE(piu_OutputLimiter_update(&limiter, 0) == 1150);
+        for (int i = 0; i < 20; ++i) { piu_OutputLimiter_tick(&limiter); }
+        REQUIRE(piu_OutputLimiter_getOutput(&limiter) == 0);
+
+        piu_OutputLimiter_setLimits(&limiter, 0, 0);
+        REQUIRE(piu_OutputLimiter_update(&limiter, UINT16_MAX) == UINT16_MAX);
+    }
+
+    SECTION("Noisy margined linear input")
+    {
+        auto ml = piu_MarginedLinear_make(0, 0, 1000, 2000, 3000, 3000, 0, 0,
+                                          10000, 10000);
+        piu_OutputLimiter_construct(&limiter, 200, 50, 0);
+
+        // Settle on the noise free output
+        for (int i = 0; i < 100; ++i)
+        {
+            piu_OutputLimiter_update(&limiter,
+                                     piu_MarginedLinear_setX(&ml, 1500));
+        }
+        REQUIRE(piu_OutputLimiter_getOutput(&limiter) == 5000);
+        piu_OutputLimiter_getChanged(&limiter);
+
+        // +-4 counts of noise is +-40 output, no writes needed
+        uint32_t writes = 0;
+        for (int i = 0; i < 1000; ++i)
+        {
+            const uint16_t x = (uint16_t)(1500 + (i * 7) % 9 - 4);
+            piu_OutputLimiter_update(&limiter, piu_MarginedLinear_setX(&ml, x));
+            writes += piu_OutputLimiter_getChanged(&limiter);
+        }
+        REQUIRE(writes == 0);
+    }
+}
@@ -0,0 +1,128 @@
+//
+// Created by YthanZhang on 2026/10/19.
+//
+
+
+#include "piu_piecewise_hysteresis.h"
+#include "piu_margined_linear.h"
+
+#include <vector>
+
+#include "catch2/catch_all.hpp"
+
+
+// Walks one breakpoint at a time like the piu_MarginedLinear state machine
+static uint16_t referenceSegment(const std::vector<piu_PiecewisePoint>& points,
+                                 uint16_t segment,
+                                 uint16_t x)
+{
+    while (segment < points.size() && x > points[segment].xRise) { ++segment; }
+    while (segment > 0 && x <= points[segment - 1].xFall) { --segment; }
+    return segment;
+}
+
+
+TEST_CASE("Piecewise hysteresis test", "[PiecewiseHysteresis]")
+{
+    std::vector<piu_PiecewisePoint> points = {
+        {.xRise = 1000, .xFall = 900, .y = 0},
+        {.xRise = 2000, .xFall = 1950, .y = 10000},
+        {.xRise = 2500, .xFall = 2500, .y = 9000},
+        {.xRise = 4000, .xFall = 3000, .y = 30000},
+        {.xRise = 4001, .xFall = 4001, .y = 65535},
+        {.xRise = 10000, .xFall = 9000, .y = 65535},
+        {.xRise = 20000, .xFall = 19000, .y = 100},
+        {.xRise = 30000, .xFall = 29990, .y = 50000},
+        {.xRise = 40000, .xFall = 39000, .y = 50001},
+        {.xRise = 50000, .xFall = 45000, .y = 1},
+    };
+
+    std::vector<piu_PiecewiseSegment> table(points.size());
+    piu_PiecewiseHysteresis curve;
+    piu_PiecewiseHysteresis_construct(
+        &curve, points.data(), table.data(), points.size());
+    REQUIRE(piu_PiecewiseHysteresis_getSegment(&curve) == 0);
+    REQUIRE(piu_PiecewiseHysteresis_getY(&curve) == 0);
+
+    SECTION("Breakpoints are hit exactly")
+    {
+        for (const auto& p : points)
+        {
+            piu_PiecewiseHysteresis_setX(&curve, p.xRise + 1);
+            REQUIRE(piu_PiecewiseHysteresis_setX(&curve, p.xRise) == p.y);
+        }
+        REQUIRE(piu_PiecewiseHysteresis_setX(&curve, 65535) == 1);
+        REQUIRE(piu_PiecewiseHysteresis_getSegment(&curve) == 10);
+    }
+
+    SECTION("Hysteresis band holds the breakpoint value")
+    {
+        piu_PiecewiseHysteresis_setX(&curve, 1500);
+        REQUIRE(piu_PiecewiseHysteresis_getY(&curve) == 5000);
+        REQUIRE(piu_PiecewiseHysteresis_setX(&curve, 950) == 0);
+        REQUIRE(piu_PiecewiseHysteresis_getSegment(&curve) == 1);
+        piu_PiecewiseHysteresis_setX(&curve, 900);
+        REQUIRE(piu_PiecewiseHysteresis_getSegment(&curve) == 0);
+        piu_PiecewiseHysteresis_setX(&curve, 1000);
+        REQUIRE(piu_PiecewiseHysteresis_getSegment(&curve) == 0);
+    }
+
+    SECTION("Matches the step by step state machine")
+    {
+        const uint32_t maxStep = GENERATE(500, 5000, 65535);
+
+        uint16_t segment = 0;
+        uint32_t seed    = 99;
+        for (int i = 0; i < 100000; ++i)
+        {
+            seed = seed * 1103515245u + 12345u;
+            int32_t x =
+                curve.lastInput + (int32_t)((seed >> 8) % (2 * maxStep + 1)) -
+                (int32_t)maxStep;
+            x = x < 0 ? 0 : x > 65535 ? 65535 : x;
+
+            segment = referenceSegment(points, segment, (uint16_t)x);
+            piu_PiecewiseHysteresis_setX(&curve, (uint16_t)x);
+            if (curve.segment != segment)
+            {
+                REQUIRE(curve.segment == segment);
+            }
+        }
+    }
+
+    SECTION("Update points")
+    {
+        piu_PiecewiseHysteresis_setX(&curve, 4500);
+        points[0].xRise = 3000;    // Out of order, raised to match
+        points[0].xFall = 3500;
+        piu_PiecewiseHysteresis_updatePoints(&curve);
+        REQUIRE(table[0].xFall == 3000);
+        REQUIRE(table[1].xRise == 3000);
+        REQUIRE(table[1].xFall == 3000);
+        REQUIRE(points[0].xFall == 3500);    // Breakpoints are left alone
+        REQUIRE(points[1].xRise == 2000);
+        REQUIRE(piu_PiecewiseHysteresis_getSegment(&curve) == 5);
+    }
+}
+
+
+TEST_CASE("Piecewise hysteresis margined linear equivalent",
+          "[PiecewiseHysteresis]")
+{
+    // Continuous margined linear curve without the on/off and max steps
+    auto ml = piu_MarginedLinear_make(300, 300, 300, 1300, 1300, 1300, 100,
+                                      100, 40000, 40000);
+    static const piu_PiecewisePoint points[] = {
+        {.xRise = 300, .xFall = 300, .y = 100},
+        {.xRise = 1300, .xFall = 1300, .y = 40000},
+    };
+    piu_PiecewiseSegment table[2];
+    piu_PiecewiseHysteresis curve;
+    piu_PiecewiseHysteresis_construct(&curve, points, table, 2);
+
+    for (uint32_t x = 0; x < 1500; ++x)
+    {
+        const int32_t y = piu_PiecewiseHysteresis_setX(&curve, (uint16_t)x);
+        REQUIRE(std::abs(y - piu_MarginedLinear_setX(&ml, (uint16_t)x)) <= 1);
+    }
+}
@@ -0,0 +1,81 @@
+//
+// Created by YthanZhang on 2026/10/19.
+//
+
+#include "piu_rt_ticker.h"
+#include "piu_atomic_vtimer.h"
+
+#include "catch2/catch_all.hpp"
+
+#include <chrono>
+#include <thread>
+
+
+static std::atomic<uint32_t> customTicks {0};
+static void customTick(void*) { customTicks.fetch_add(1); }
+
+// Blocks the ticker thread once for 10 periods at the 40th tick
+static std::atomic<uint32_t> stallTicks {0};
+static void stallOnce(void*)
+{
+    if (stallTicks.fetch_add(1) == 40)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+}
+
+
+TEST_CASE("Real-time ticker test", "[rt_ticker]")
+{
+    constexpr uint32_t periodNs = 1000000;    // 1kHz
+
+    piu_AtomicVTimer vtimer =
+        PIU_ATOMIC_VTIMER_MAKE(9, piu_VTMode_Continuous, nullptr);
+    const piu_RTTickEntry entries[] = {
+        PIU_RT_TICK_ATOMIC_VTIMER(&vtimer),
+        {customTick, nullptr},
+        {stallOnce, nullptr},
+    };
+
+    piu_RTTicker ticker;
+    piu_RTTicker_construct(&ticker, periodNs, entries, 3);
+    piu_AtomicVTimer_startCounter(&vtimer);
+    customTicks = 0;
+    stallTicks  = 0;
+
+    const auto begin = std::chrono::steady_clock::now();
+    REQUIRE(piu_RTTicker_start(&ticker, 50) == 0);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    piu_RTTicker_stop(&ticker);
+    const auto elapsedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                               std::chrono::steady_clock::now() - begin)
+                               .count();
+
+    piu_RTTickerStats stats;
+    piu_RTTicker_getStats(&ticker, &stats);
+
+    // The stall is absorbed by batch advancing, the tick count still follows
+    // the wall clock, no drift
+    REQUIRE(stats.missedTicks >= 5);
+    REQUIRE(stats.maxLatencyNs >= 5 * periodNs);
+    const auto expected = (uint64_t)elapsedNs / periodNs;
+    REQUIRE(stats.ticks <= expected);
+    REQUIRE(stats.ticks + 5 >= expected);
+
+    REQUIRE(stats.ticks == stats.wakeups + stats.missedTicks);
+    REQUIRE(customTicks.load() == stats.ticks);
+    REQUIRE(stallTicks.load() == stats.ticks);
+    REQUIRE(stats.minLatencyNs <= stats.avgLatencyNs);
+    REQUIRE(stats.avgLatencyNs <= stats.maxLatencyNs);
+    REQUIRE(stats.p99LatencyNs <= stats.maxLatencyNs);
+
+    // Every 10th tick overflows the vtimer
+    REQUIRE(piu_AtomicVTimer_getOverflow(&vtimer));
+
+    piu_RTTicker_resetStats(&ticker);
+    piu_RTTicker_getStats(&ticker, &stats);
+    REQUIRE(stats.ticks == 0);
+    REQUIRE(stats.maxLatencyNs == 0);
+}
@@ -0,0 +1,92 @@
+//
+// Created by YthanZhang on 2026/10/19.
+//
+
+#include "piu_sim_uart_autobaud.h"
+
+#include "catch2/catch_all.hpp"
+
+
+static uint16_t lockedBitTime = 0;
+static void setBitTime(uint16_t bitTime) { lockedBitTime = bitTime; }
+
+
+// Run one 8N1 frame on the line, one clock tick per loop, then idle
+static bool runFrame(piu_VTimer* clock,
+                     piu_SimUARTAutoBaud* autoBaud,
+                     uint8_t val,
+                     uint16_t bitTime,
+                     uint16_t idleBits)
+{
+    const uint16_t frame = (uint16_t)(0x200 | (val << 1));
+
+    bool level = true;
+    for (uint32_t t = 0; t < (uint32_t)bitTime * (10 + idleBits); ++t)
+    {
+        const uint32_t bit = t / bitTime;
+        const bool rx      = bit < 10 ? (frame >> bit) & 0x01 : true;
+        if (rx != level)
+        {
+            level = rx;
+            piu_SimUARTAutoBaud_edge(autoBaud, rx);
+        }
+
+        piu_VTimer_tick(clock);
+        if (piu_SimUARTAutoBaud_update(autoBaud))
+        {
+            // Locked within the sync frame, before the stop bit is over
+            REQUIRE(t < (uint32_t)bitTime * 10);
+            return true;
+        }
+    }
+    return false;
+}
+
+
+TEST_CASE("Sim UART auto baud test", "[sim_uart_autobaud]")
+{
+    static const uint16_t bitTimes[] = {104, 52, 26};
+
+    piu_VTimer clock;
+    piu_VTimer_construct(&clock, 0xFFFF, piu_VTMode_Continuous, nullptr);
+    piu_VTimer_startCounter(&clock);
+    for (int i = 0; i < 0xFFF0; ++i) { piu_VTimer_tick(&clock); }    // wrap
+
+    piu_SimUARTAutoBaud autoBaud;
+    piu_SimUARTAutoBaud_construct(&autoBaud, &clock, bitTimes, 3, setBitTime);
+    lockedBitTime = 0;
+
+    SECTION("0x55 sync character")
+    {
+        const uint16_t bitTime = GENERATE(104, 52, 26);
+        REQUIRE(runFrame(&clock, &autoBaud, 0x55, bitTime, 2));
+        REQUIRE(piu_SimUARTAutoBaud_getLocked(&autoBaud));
+        REQUIRE(piu_SimUARTAutoBaud_getBitTime(&autoBaud) == bitTime);
+        REQUIRE(lockedBitTime == bitTime);
+    }
+
+    SECTION("Modbus address byte, slightly off rate")
+    {
+        REQUIRE(runFrame(&clock, &autoBaud, 0x11, 50, 2));
+        REQUIRE(piu_SimUARTAutoBaud_getBitTime(&autoBaud) == 52);
+    }
+
+    SECTION("ambiguous byte is discarded, next sync locks")
+    {
+        REQUIRE_FALSE(runFrame(&clock, &autoBaud, 0xF0, 26, 60));
+        REQUIRE_FALSE(piu_SimUARTAutoBaud_getLocked(&autoBaud));
+
+        REQUIRE(runFrame(&clock, &autoBaud, 0x55, 26, 2));
+        REQUIRE(lockedBitTime == 26);
+
+        piu_SimUARTAutoBaud_restart(&autoBaud);
+        REQUIRE(piu_SimUARTAutoBaud_getBitTime(&autoBaud) == 0);
+        REQUIRE(runFrame(&clock, &autoBaud, 0x55, 104, 2));
+        REQUIRE(lockedBitTime == 104);
+    }
+
+    SECTION("unsupported rate does not lock")
+    {
+        REQUIRE_FALSE(runFrame(&clock, &autoBaud, 0x55, 75, 40));
+    }
+}
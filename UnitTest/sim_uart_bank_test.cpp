@@ -0,0 +1,97 @@
+//
+// Created by YthanZhang on 2026/10/19.
+//
+
+#include "piu_sim_uart_bank.h"
+
+#include "catch2/catch_all.hpp"
+
+#include <vector>
+
+
+// Samples of one 8N1 frame on a single line, idle high before and after
+static std::vector<bool> frameSamples(uint8_t val, uint8_t oversample)
+{
+    const uint16_t frame = (uint16_t)(0x200 | (val << 1));
+
+    std::vector<bool> samples(oversample, true);
+    for (int bit = 0; bit < 10; ++bit)
+    {
+        samples.insert(samples.end(), oversample, (frame >> bit) & 0x01);
+    }
+    samples.insert(samples.end(), oversample, true);
+    return samples;
+}
+
+
+TEST_CASE("Sim UART bank test", "[sim_uart_bank]")
+{
+    const uint8_t oversample = GENERATE(3, 16);
+
+    piu_SimUARTBank bank;
+    piu_SimUARTBank_construct(&bank, 0x0F, 0xF0, oversample);
+
+    SECTION("idle Tx lines are high")
+    {
+        REQUIRE(piu_SimUARTBank_update(&bank, 0x0F) == 0xF0);
+        REQUIRE_FALSE(piu_SimUARTBank_sendTx(&bank, 0, 0x55));
+        REQUIRE_FALSE(piu_SimUARTBank_sendTx(&bank, 40, 0x55));
+    }
+
+    SECTION("Tx channels loop back into Rx channels")
+    {
+        const uint8_t bytes[] = {0x55, 0xA3, 0x00, 0xFF};
+
+        // Staggered starts, every Rx channel gets its own phase
+        uint32_t txWord = 0xF0;
+        for (int update = 0; update < 20 * oversample; ++update)
+        {
+            if (update % oversample == 1 && update / oversample < 4)
+            {
+                uint8_t ch = (uint8_t)(update / oversample);
+                REQUIRE(piu_SimUARTBank_sendTx(&bank, ch + 4, bytes[ch]));
+            }
+            txWord = piu_SimUARTBank_update(&bank, txWord >> 4);
+        }
+
+        REQUIRE(piu_SimUARTBank_getTxBusy(&bank) == 0);
+        REQUIRE(piu_SimUARTBank_getRxComplete(&bank) == 0x0F);
+        REQUIRE(piu_SimUARTBank_getRxFrameErr(&bank) == 0);
+        REQUIRE(piu_SimUARTBank_getRxNoise(&bank) == 0);
+        for (uint8_t ch = 0; ch < 4; ++ch)
+        {
+            REQUIRE(piu_SimUARTBank_getRx(&bank, ch) == bytes[ch]);
+        }
+        REQUIRE(piu_SimUARTBank_getRxComplete(&bank) == 0);
+    }
+
+    SECTION("Rx glitches, frame errors and false starts per channel")
+    {
+        std::vector<bool> clean  = frameSamples(0x3C, oversample);
+        std::vector<bool> noisy  = clean;
+        std::vector<bool> broken = clean;
+
+        noisy[oversample * 3 + oversample / 2] =
+            !noisy[oversample * 3 + oversample / 2];
+        for (size_t i = oversample * 10; i < oversample * 11; ++i)
+        {
+            broken[i] = false;    // Stop bit low
+        }
+
+        for (size_t i = 0; i < clean.size(); ++i)
+        {
+            // Channel 3 only sees a one sample low pulse
+            uint32_t port = (clean[i] ? 0x01 : 0) | (noisy[i] ? 0x02 : 0) |
+                            (broken[i] ? 0x04 : 0) |
+                            (i == 2 ? 0 : 0x08);
+            piu_SimUARTBank_update(&bank, port);
+        }
+
+        REQUIRE(piu_SimUARTBank_getRxComplete(&bank) == 0x03);
+        REQUIRE(piu_SimUARTBank_getRxFrameErr(&bank) == 0x04);
+        REQUIRE(piu_SimUARTBank_getRxFrameErr(&bank) == 0);
+        REQUIRE((piu_SimUARTBank_getRxNoise(&bank) & 0x03) == 0x02);
+        REQUIRE(piu_SimUARTBank_getRx(&bank, 0) == 0x3C);
+        REQUIRE(piu_SimUARTBank_getRx(&bank, 1) == 0x3C);
+    }
+}
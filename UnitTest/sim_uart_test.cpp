@@ -8,6 +8,7 @@
 #include "catch2/catch_all.hpp"
 
 #include <iostream>
+#include <vector>
 
 
 bool tx = true;
@@ -113,3 +114,468 @@ TEST_CASE("Sim UART Test", "[sim_uart]")
     rxVal = 0b1101010101;
     REQUIRE(piu_SimUART_getRx(&simUART) == (rxVal & 0xFF));
 }
+
+
+TEST_CASE("Sim UART FIFO Test", "[sim_uart]")
+{
+    uint8_t rxStorage[2];
+    uint8_t txStorage[4];
+
+    piu_SimUART_construct(&simUART, setTxBit);
+    REQUIRE_FALSE(piu_SimUART_attachFifo(&simUART, rxStorage, 3, nullptr, 0));
+    REQUIRE(piu_SimUART_attachFifo(&simUART, rxStorage, 2, txStorage, 4));
+
+    /** Test back to back Tx **************************************************/
+    const uint8_t txBytes[] = {0xA5, 0x0F, 0x81};
+    for (uint8_t byte : txBytes) { REQUIRE(piu_SimUART_sendTx(&simUART, byte)); }
+    REQUIRE(piu_SimUART_getTxFree(&simUART) == 2);
+
+    std::vector<bool> line;
+    while (piu_SimUART_txTIMUpdate(&simUART)) { line.push_back(tx); }
+    line.push_back(tx);
+
+    // start + 8 data + stop per byte, no idle bit between frames
+    REQUIRE(line.size() == 3 * 10 + 1);
+    for (size_t i = 0; i < 3; ++i)
+    {
+        REQUIRE_FALSE(line[i * 10]);
+        for (size_t bit = 0; bit < 8; ++bit)
+        {
+            REQUIRE(line[i * 10 + 1 + bit] == ((txBytes[i] >> bit) & 0x01));
+        }
+        REQUIRE(line[i * 10 + 9]);
+    }
+    REQUIRE(piu_SimUART_getTxComplete(&simUART));
+
+    /** Test Rx burst and overrun *********************************************/
+    for (uint8_t byte : txBytes)
+    {
+        uint16_t frame = (uint16_t)(0x200 | (byte << 1));
+        piu_SimUART_GPIOUpdate(&simUART, false);
+        for (int bit = 1; bit < 10; ++bit)
+        {
+            piu_SimUART_rxTIMUpdate(&simUART, (frame >> bit) & 0x01);
+        }
+    }
+
+    REQUIRE(piu_SimUART_getRxOverrun(&simUART));
+    REQUIRE_FALSE(piu_SimUART_getRxOverrun(&simUART));
+    REQUIRE(piu_SimUART_getRxCount(&simUART) == 2);
+    REQUIRE(piu_SimUART_getRxComplete(&simUART));
+    REQUIRE(piu_SimUART_getRx(&simUART) == txBytes[0]);
+    REQUIRE(piu_SimUART_getRx(&simUART) == txBytes[1]);
+    REQUIRE_FALSE(piu_SimUART_getRxComplete(&simUART));
+}
+
+
+TEST_CASE("Sim UART Tx Register Test", "[sim_uart]")
+{
+    volatile uint32_t odr  = 0xF0;
+    volatile uint32_t bsrr = 0;
+    volatile uint32_t brr  = 0;
+
+    piu_SimUART_construct(&simUART, setTxBit);
+
+    /** Test read-modify-write output data register ***************************/
+    piu_SimUART_setTxRegisters(&simUART, &odr, nullptr, 0x04);
+    tx = true;
+    REQUIRE(piu_SimUART_sendTx(&simUART, 0x5A));
+
+    uint16_t txVal = (uint16_t)(0x200 | (0x5A << 1));
+    for (int i = 0; i < 10; ++i)
+    {
+        REQUIRE(piu_SimUART_txTIMUpdate(&simUART));
+        REQUIRE((odr & ~0x04u) == 0xF0);
+        REQUIRE(bool(odr & 0x04) == bool(txVal & 0x01));
+        txVal >>= 1;
+    }
+    REQUIRE_FALSE(piu_SimUART_txTIMUpdate(&simUART));
+    REQUIRE(odr == 0xF4);
+    REQUIRE(piu_SimUART_getTxComplete(&simUART));
+    REQUIRE(tx);    // setTxFunc is not called
+
+    /** Test separate set and clear registers *********************************/
+    piu_SimUART_setTxRegisters(&simUART, &bsrr, &brr, 0x08);
+    REQUIRE(piu_SimUART_sendTx(&simUART, 0x00));
+    piu_SimUART_txTIMUpdate(&simUART);
+    REQUIRE(brr == 0x08);
+    REQUIRE(bsrr == 0);
+    while (piu_SimUART_txTIMUpdate(&simUART)) {}
+    REQUIRE(bsrr == 0x08);
+
+    /** Test back to setTxFunc ************************************************/
+    piu_SimUART_setTxRegisters(&simUART, nullptr, nullptr, 0);
+    REQUIRE(piu_SimUART_sendTx(&simUART, 0x00));
+    piu_SimUART_txTIMUpdate(&simUART);
+    REQUIRE_FALSE(tx);
+    while (piu_SimUART_txTIMUpdate(&simUART)) {}
+    REQUIRE(tx);
+}
+
+
+static std::vector<bool> sendFrame(uint16_t val)
+{
+    std::vector<bool> line;
+    REQUIRE(piu_SimUART_sendTxWord(&simUART, val));
+    while (piu_SimUART_txTIMUpdate(&simUART)) { line.push_back(tx); }
+    return line;
+}
+
+static void receiveFrame(const std::vector<bool>& line)
+{
+    piu_SimUART_GPIOUpdate(&simUART, line[0]);
+    for (size_t i = 1; i < line.size(); ++i)
+    {
+        piu_SimUART_rxTIMUpdate(&simUART, line[i]);
+    }
+}
+
+
+TEST_CASE("Sim UART Frame Format Test", "[sim_uart]")
+{
+    piu_SimUART_construct(&simUART, setTxBit);
+    REQUIRE_FALSE(piu_SimUART_setFormat(
+        &simUART, PIU_SIM_UART_FORMAT(4, piu_SimUARTParity_None, 1)));
+    REQUIRE_FALSE(piu_SimUART_setFormat(
+        &simUART, PIU_SIM_UART_FORMAT(8, 3, 1)));
+
+    /** Test 8E1 **************************************************************/
+    REQUIRE(piu_SimUART_setFormat(
+        &simUART, PIU_SIM_UART_FORMAT(8, piu_SimUARTParity_Even, 1)));
+
+    std::vector<bool> line = sendFrame(0x07);
+    REQUIRE(line.size() == 11);
+    REQUIRE_FALSE(line[0]);
+    REQUIRE(line[9]);    // 3 bits set, even parity bit is 1
+    REQUIRE(line[10]);
+
+    receiveFrame(line);
+    REQUIRE(piu_SimUART_getRxComplete(&simUART));
+    REQUIRE_FALSE(piu_SimUART_getRxParityErr(&simUART));
+    REQUIRE(piu_SimUART_getRx(&simUART) == 0x07);
+
+    line[9] = false;
+    receiveFrame(line);
+    REQUIRE_FALSE(piu_SimUART_getRxComplete(&simUART));
+    REQUIRE_FALSE(piu_SimUART_getRxFrameErr(&simUART));
+    REQUIRE(piu_SimUART_getRxParityErr(&simUART));
+    REQUIRE_FALSE(piu_SimUART_getRxParityErr(&simUART));
+
+    /** Test 7O2 **************************************************************/
+    REQUIRE(piu_SimUART_setFormat(
+        &simUART, PIU_SIM_UART_FORMAT(7, piu_SimUARTParity_Odd, 2)));
+
+    line = sendFrame(0x03);
+    REQUIRE(line.size() == 11);
+    REQUIRE(line[8]);    // 2 bits set, odd parity bit is 1
+    REQUIRE(line[9]);
+    REQUIRE(line[10]);
+
+    receiveFrame(std::vector<bool>(line.begin(), line.end() - 1));
+    REQUIRE(piu_SimUART_getRx(&simUART) == 0x03);
+}
+
+
+TEST_CASE("Sim UART 9-bit Address Filter Test", "[sim_uart]")
+{
+    piu_SimUART_construct(&simUART, setTxBit);
+    REQUIRE(piu_SimUART_setFormat(
+        &simUART, PIU_SIM_UART_FORMAT(9, piu_SimUARTParity_None, 1)));
+
+    std::vector<bool> addrOther = sendFrame(0x100 | 0x21);
+    std::vector<bool> addrSelf  = sendFrame(0x100 | 0x42);
+    std::vector<bool> data      = sendFrame(0x5A);
+    REQUIRE(addrSelf.size() == 11);
+
+    receiveFrame(addrSelf);
+    REQUIRE(piu_SimUART_getRxWord(&simUART) == (0x100 | 0x42));
+
+    piu_SimUART_setAddressFilter(&simUART, 0x42, true);
+
+    receiveFrame(data);    // not selected yet
+    REQUIRE_FALSE(piu_SimUART_getRxComplete(&simUART));
+
+    receiveFrame(addrSelf);
+    REQUIRE_FALSE(piu_SimUART_getRxComplete(&simUART));
+    receiveFrame(data);
+    REQUIRE(piu_SimUART_getRxComplete(&simUART));
+    REQUIRE(piu_SimUART_getRx(&simUART) == 0x5A);
+
+    receiveFrame(addrOther);
+    receiveFrame(data);
+    REQUIRE_FALSE(piu_SimUART_getRxComplete(&simUART));
+}
+
+
+TEST_CASE("Sim UART Oversampled Rx Test", "[sim_uart]")
+{
+    piu_SimUART_construct(&simUART, setTxBit);
+    REQUIRE_FALSE(piu_SimUART_setOversample(&simUART, 8));
+    REQUIRE(piu_SimUART_getOversample(&simUART) == 0);
+
+    for (uint8_t ratio : {3, 16})
+    {
+        REQUIRE(piu_SimUART_setOversample(&simUART, ratio));
+        REQUIRE(piu_SimUART_getOversample(&simUART) == ratio);
+
+        // Idle line, then frame for 0xC5 starting at a phase offset
+        uint16_t frame = (uint16_t)(0x200 | (0xC5 << 1));
+        std::vector<bool> samples(ratio + 1, true);
+        for (int bit = 0; bit < 10; ++bit)
+        {
+            for (uint8_t i = 0; i < ratio; ++i)
+            {
+                samples.push_back((frame >> bit) & 0x01);
+            }
+        }
+        samples.insert(samples.end(), ratio, true);
+
+        for (bool sample : samples)
+        {
+            piu_SimUART_rxSampleUpdate(&simUART, sample);
+        }
+        REQUIRE(piu_SimUART_getRxComplete(&simUART));
+        REQUIRE_FALSE(piu_SimUART_getRxNoise(&simUART));
+        REQUIRE(piu_SimUART_getRx(&simUART) == 0xC5);
+
+        // A glitch within a bit is voted out but reported as noise
+        size_t bit3 = ratio + 1 + 3 * ratio + ratio / 2;
+        samples[bit3] = !samples[bit3];
+        for (bool sample : samples)
+        {
+            piu_SimUART_rxSampleUpdate(&simUART, sample);
+        }
+        REQUIRE(piu_SimUART_getRxNoise(&simUART));
+        REQUIRE(piu_SimUART_getRx(&simUART) == 0xC5);
+
+        // A short low pulse is not a start bit
+        piu_SimUART_rxSampleUpdate(&simUART, false);
+        for (int i = 0; i < ratio; ++i)
+        {
+            piu_SimUART_rxSampleUpdate(&simUART, true);
+        }
+        piu_SimUART_getRxNoise(&simUART);
+        for (int i = 0; i < 10 * ratio; ++i)
+        {
+            REQUIRE_FALSE(piu_SimUART_rxSampleUpdate(&simUART, true));
+        }
+        REQUIRE_FALSE(piu_SimUART_getRxComplete(&simUART));
+    }
+}
+
+
+TEST_CASE("Sim UART Buffer Encode Decode Test", "[sim_uart]")
+{
+    const uint8_t bytes[] = {0x00, 0x55, 0xFF, 0x81};
+    const uint8_t format =
+        PIU_SIM_UART_FORMAT(8, piu_SimUARTParity_Even, 1);
+
+    std::vector<uint8_t> pins(4 * 11 * 8);
+    REQUIRE(piu_SimUART_encodePins(format, bytes, 4, 8, pins.data(), 10) == 0);
+    REQUIRE(piu_SimUART_encodePins(
+                format, bytes, 4, 8, pins.data(), pins.size()) == pins.size());
+
+    // Encoded waveform matches what the Tx interrupt outputs
+    piu_SimUART_construct(&simUART, setTxBit);
+    piu_SimUART_setFormat(&simUART, format);
+    REQUIRE(piu_SimUART_sendTx(&simUART, bytes[1]));
+    for (size_t bit = 0; bit < 11; ++bit)
+    {
+        piu_SimUART_txTIMUpdate(&simUART);
+        REQUIRE(tx == bool(pins[(11 + bit) * 8]));
+    }
+
+    // Idle before and after, one glitch sample, one broken stop bit
+    std::vector<uint8_t> capture(5, 1);
+    capture.insert(capture.end(), pins.begin(), pins.end());
+    capture.insert(capture.end(), 5, 1);
+    capture[5 + 11 * 8 + 3 * 8 + 2] ^= 1;
+    for (size_t i = 0; i < 8; ++i) { capture[5 + 3 * 88 - 8 + i] = 0; }
+
+    // The frame after the broken stop bit has no falling edge and is lost
+    uint16_t frames[8];
+    REQUIRE(piu_SimUART_decodePins(
+                format, capture.data(), capture.size(), 8, frames, 8) == 3);
+    REQUIRE(frames[0] == 0x00);
+    REQUIRE(frames[1] == 0x55);
+    REQUIRE(frames[2] == (0xFF | PIU_SIM_UART_DECODE_FRAME_ERR));
+
+    capture[5 + 3 * 88 - 1] = 1;
+    REQUIRE(piu_SimUART_decodePins(
+                format, capture.data(), capture.size(), 8, frames, 8) == 4);
+    REQUIRE(frames[3] == 0x81);
+
+    for (size_t i = 0; i < 8; ++i)    // Data bit 0 of 0x81 flipped
+    {
+        capture[5 + 3 * 88 + 8 + i] = 0;
+    }
+    REQUIRE(piu_SimUART_decodePins(
+                format, capture.data(), capture.size(), 8, frames, 8) == 4);
+    REQUIRE(frames[3] == (0x80 | PIU_SIM_UART_DECODE_PARITY_ERR));
+
+    /** Test port words *******************************************************/
+    const uint8_t format8N1 = PIU_SIM_UART_FORMAT_8N1;
+    std::vector<uint32_t> words(4 * 10 * 3 + 1, 0x10);
+    REQUIRE(piu_SimUART_encodePortWords(format8N1, bytes, 4, 3, 0x10, 0x100000,
+                                        words.data() + 1, words.size() - 1) ==
+            4 * 10 * 3);
+    REQUIRE(words[1] == 0x100000);
+    REQUIRE(words[3 * 10 - 1] == 0x10);    // Stop bit of the first frame
+
+    for (uint32_t& word : words) { word = (word & 0x10) | 0x01; }
+    REQUIRE(piu_SimUART_decodePortWords(
+                format8N1, words.data(), words.size(), 3, 0x10, frames, 2) ==
+            2);
+    REQUIRE(frames[0] == 0x00);
+    REQUIRE(frames[1] == 0x55);
+
+    words[1 + 3 * 10 + 1] = 0x10;    // Glitch in a start bit is voted out
+    REQUIRE(piu_SimUART_decodePortWords(
+                format8N1, words.data(), words.size(), 3, 0x10, frames, 8) ==
+            4);
+    REQUIRE(frames[3] == 0x81);
+}
+
+
+TEST_CASE("Sim UART Buffer Round Trip Test", "[sim_uart]")
+{
+    // Encoder output starts right at a start bit, no idle in front
+    const uint8_t bytes[] = {0x55, 0xA3, 0x0F};
+    const uint8_t format  = GENERATE(PIU_SIM_UART_FORMAT_8N1,
+                                    PIU_SIM_UART_FORMAT(
+                                        7, piu_SimUARTParity_Odd, 2));
+    const uint8_t samplesPerBit = GENERATE(1, 3, 8);
+    const size_t count          = 12 * samplesPerBit * 3;
+    uint16_t frames[4];
+
+    std::vector<uint8_t> pins(count);
+    const size_t pinCount = piu_SimUART_encodePins(
+        format, bytes, 3, samplesPerBit, pins.data(), pins.size());
+    REQUIRE(pinCount != 0);
+    REQUIRE(pins[0] == 0);
+    REQUIRE(piu_SimUART_decodePins(
+                format, pins.data(), pinCount, samplesPerBit, frames, 4) == 3);
+    const uint16_t mask = format == PIU_SIM_UART_FORMAT_8N1 ? 0xFF : 0x7F;
+    for (size_t i = 0; i < 3; ++i) { REQUIRE(frames[i] == (bytes[i] & mask)); }
+
+    std::vector<uint32_t> words(count);
+    const size_t wordCount =
+        piu_SimUART_encodePortWords(format, bytes, 3, samplesPerBit, 0x10, 0x01,
+                                    words.data(), words.size());
+    REQUIRE(wordCount == pinCount);
+    REQUIRE(piu_SimUART_decodePortWords(format, words.data(), wordCount,
+                                        samplesPerBit, 0x10, frames, 4) == 3);
+    for (size_t i = 0; i < 3; ++i) { REQUIRE(frames[i] == (bytes[i] & mask)); }
+}
+
+
+TEST_CASE("Sim UART Full Duplex Test", "[sim_uart]")
+{
+    constexpr uint8_t ratio = 16;
+
+    piu_SimUART_construct(&simUART, setTxBit);
+    REQUIRE(piu_SimUART_setOversample(&simUART, ratio));
+
+    // Rx frame starts 5 updates after Tx, off the Tx bit phase
+    const uint16_t rxFrame = (uint16_t)(0x200 | (0x3A << 1));
+    std::vector<bool> rxLine(ratio + 5, true);
+    for (int bit = 0; bit < 10; ++bit)
+    {
+        rxLine.insert(rxLine.end(), ratio, (rxFrame >> bit) & 0x01);
+    }
+    rxLine.insert(rxLine.end(), ratio, true);
+
+    REQUIRE(piu_SimUART_sendTx(&simUART, 0xC3));
+
+    std::vector<bool> txLine;
+    for (bool rx : rxLine)
+    {
+        piu_SimUART_fullDuplexTIMUpdate(&simUART, rx);
+        txLine.push_back(tx);
+    }
+
+    // Both directions finish at full speed
+    REQUIRE(piu_SimUART_getTxComplete(&simUART));
+    REQUIRE(piu_SimUART_getRxComplete(&simUART));
+    REQUIRE(piu_SimUART_getRx(&simUART) == 0x3A);
+
+    const uint16_t txFrame = (uint16_t)(0x200 | (0xC3 << 1));
+    for (size_t i = 0; i < 10 * ratio; ++i)
+    {
+        REQUIRE(txLine[i] == bool((txFrame >> (i / ratio)) & 0x01));
+    }
+    REQUIRE(txLine[10 * ratio]);
+}
+
+
+static std::vector<std::pair<size_t, bool>> deEvents;
+static size_t txUpdates = 0;
+static void setDE(bool deVal) { deEvents.emplace_back(txUpdates, deVal); }
+
+
+TEST_CASE("Sim UART RS-485 Test", "[sim_uart]")
+{
+    uint8_t txStorage[4];
+    piu_SimUART_construct(&simUART, setTxBit);
+    piu_SimUART_attachFifo(&simUART, nullptr, 0, txStorage, 4);
+
+    /** Test driver enable timing *********************************************/
+    piu_SimUART_setDriverEnable(&simUART, setDE);
+    deEvents.clear();
+    txUpdates = 0;
+
+    REQUIRE(piu_SimUART_sendTx(&simUART, 0x12));
+    REQUIRE(piu_SimUART_sendTx(&simUART, 0x34));
+    REQUIRE(deEvents.size() == 1);
+    REQUIRE(deEvents[0] == std::make_pair(size_t(0), true));
+
+    std::vector<bool> line;
+    while (true)
+    {
+        ++txUpdates;
+        bool busy = piu_SimUART_txTIMUpdate(&simUART);
+        line.push_back(tx);
+        if (!busy) { break; }
+    }
+
+    // Released on the update right after the second stop bit
+    REQUIRE(line.size() == 21);
+    REQUIRE(line[19]);    // Last stop bit
+    REQUIRE(deEvents.size() == 2);
+    REQUIRE(deEvents[1] == std::make_pair(size_t(21), false));
+
+    /** Test idle gap and break ***********************************************/
+    constexpr uint8_t ratio = 3;
+    piu_SimUART_setOversample(&simUART, ratio);
+    piu_SimUART_setIdleDetect(&simUART, 39);
+
+    auto feed = [](bool level, int bits) {
+        for (int i = 0; i < bits * ratio; ++i)
+        {
+            piu_SimUART_rxSampleUpdate(&simUART, level);
+        }
+    };
+
+    feed(true, 60);    // No frame yet, no message end
+    REQUIRE_FALSE(piu_SimUART_getRxIdle(&simUART));
+
+    const uint16_t frame = (uint16_t)(0x200 | (0x01 << 1));
+    for (int bit = 0; bit < 10; ++bit) { feed((frame >> bit) & 0x01, 1); }
+    feed(true, 38);
+    REQUIRE_FALSE(piu_SimUART_getRxIdle(&simUART));
+    feed(true, 2);
+    REQUIRE(piu_SimUART_getRxIdle(&simUART));
+    feed(true, 60);
+    REQUIRE_FALSE(piu_SimUART_getRxIdle(&simUART));
+
+    feed(false, 9);    // 0x00 frame is not a break
+    feed(true, 1);
+    REQUIRE_FALSE(piu_SimUART_getRxBreak(&simUART));
+    REQUIRE(piu_SimUART_getRx(&simUART) == 0x00);
+
+    feed(false, 11);
+    REQUIRE(piu_SimUART_getRxBreak(&simUART));
+    REQUIRE(piu_SimUART_getRxFrameErr(&simUART));
+    feed(false, 30);
+    REQUIRE_FALSE(piu_SimUART_getRxBreak(&simUART));
+}
@@ -0,0 +1,86 @@
+//
+// Created by YthanZhang on 2026/10/19.
+//
+
+#include "piu_sim_uart_wire.h"
+
+#include "catch2/catch_all.hpp"
+
+#include <vector>
+
+
+static void unusedTx(bool) {}
+
+
+// Send count bytes over a wire, return the bytes received
+static std::vector<uint8_t> transfer(int32_t rxSkewPpm,
+                                     uint16_t jitterPermille,
+                                     uint16_t noise,
+                                     uint32_t seed,
+                                     size_t count)
+{
+    piu_SimUART txUART;
+    piu_SimUART rxUART;
+    uint8_t txStorage[64];
+    uint8_t rxStorage[64];
+
+    piu_SimUART_construct(&txUART, unusedTx);
+    piu_SimUART_construct(&rxUART, unusedTx);
+    piu_SimUART_attachFifo(&txUART, nullptr, 0, txStorage, 64);
+    piu_SimUART_attachFifo(&rxUART, rxStorage, 64, nullptr, 0);
+
+    piu_SimUARTWire wire;
+    piu_SimUARTWire_construct(
+        &wire, &txUART, &rxUART, rxSkewPpm, jitterPermille, noise, seed);
+    piu_SimUARTWire_run(&wire, 4);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        REQUIRE(piu_SimUART_sendTx(&txUART, (uint8_t)(i * 37 + 11)));
+    }
+    piu_SimUARTWire_run(&wire, (uint32_t)count * 10 + 4);
+
+    std::vector<uint8_t> received;
+    while (piu_SimUART_getRxCount(&rxUART) != 0)
+    {
+        received.push_back(piu_SimUART_getRx(&rxUART));
+    }
+    return received;
+}
+
+static std::vector<uint8_t> expected(size_t count)
+{
+    std::vector<uint8_t> bytes;
+    for (size_t i = 0; i < count; ++i)
+    {
+        bytes.push_back((uint8_t)(i * 37 + 11));
+    }
+    return bytes;
+}
+
+
+TEST_CASE("Sim UART virtual wire test", "[sim_uart_wire]")
+{
+    SECTION("clean wire")
+    {
+        REQUIRE(transfer(0, 0, 0, 1, 48) == expected(48));
+    }
+
+    SECTION("clock skew and jitter within tolerance")
+    {
+        const int32_t skew = GENERATE(-20000, 20000);
+        REQUIRE(transfer(skew, 150, 0, 7, 48) == expected(48));
+    }
+
+    SECTION("too much clock skew corrupts frames")
+    {
+        REQUIRE(transfer(80000, 0, 0, 1, 48) != expected(48));
+    }
+
+    SECTION("noise is voted out and runs are deterministic")
+    {
+        const std::vector<uint8_t> first = transfer(0, 0, 600, 42, 48);
+        REQUIRE(first == transfer(0, 0, 600, 42, 48));
+        REQUIRE(first == expected(48));
+    }
+}
@@ -0,0 +1,66 @@
+//
+// Created by YthanZhang on 2026/10/19.
+//
+
+#include "piu_soft_pwm.h"
+
+#include "catch2/catch_all.hpp"
+
+
+TEST_CASE("Software PWM bank test", "[soft_pwm]")
+{
+    constexpr uint16_t period = 10;
+
+    piu_SoftPWM pwm;
+    piu_SoftPWM_construct(&pwm, period, 24);
+
+    SECTION("outputs match duty values")
+    {
+        const uint16_t duty[] = {0, 3, 3, 10, 1, 9, 12};
+        for (uint8_t ch = 0; ch < 7; ++ch)
+        {
+            piu_SoftPWM_setDuty(&pwm, ch, duty[ch]);
+        }
+        REQUIRE(piu_SoftPWM_getDuty(&pwm, 6) == period);
+        REQUIRE(piu_SoftPWM_commit(&pwm));
+
+        for (int p = 0; p < 3; ++p)
+        {
+            for (uint16_t t = 0; t < period; ++t)
+            {
+                uint32_t expected = 0;
+                for (uint8_t ch = 0; ch < 7; ++ch)
+                {
+                    if (t < duty[ch]) { expected |= 1u << ch; }
+                }
+                REQUIRE(piu_SoftPWM_tick(&pwm) == expected);
+            }
+        }
+    }
+
+    SECTION("duty updates apply at period boundary")
+    {
+        piu_SoftPWM_setDuty(&pwm, 23, 5);
+        piu_SoftPWM_commit(&pwm);
+
+        for (uint16_t t = 0; t < 3; ++t) { piu_SoftPWM_tick(&pwm); }
+
+        piu_SoftPWM_setDuty(&pwm, 23, 8);
+        REQUIRE(piu_SoftPWM_commit(&pwm));
+        REQUIRE_FALSE(piu_SoftPWM_commit(&pwm));    // still pending
+
+        // remainder of the period still uses duty 5
+        for (uint16_t t = 3; t < period; ++t)
+        {
+            REQUIRE(piu_SoftPWM_tick(&pwm) == (t < 5 ? 1u << 23 : 0u));
+        }
+        REQUIRE(piu_SoftPWM_getCommitPending(&pwm));
+
+        // next period uses duty 8
+        for (uint16_t t = 0; t < period; ++t)
+        {
+            REQUIRE(piu_SoftPWM_tick(&pwm) == (t < 8 ? 1u << 23 : 0u));
+        }
+        REQUIRE_FALSE(piu_SoftPWM_getCommitPending(&pwm));
+    }
+}
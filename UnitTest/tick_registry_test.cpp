@@ -0,0 +1,44 @@
+//
+// Created by YthanZhang on 2026/10/19.
+//
+
+#include "piu_tick_registry.h"
+
+#include "catch2/catch_all.hpp"
+
+
+static uint32_t customTicks = 0;
+static void customTick(void* object)
+{
+    ++customTicks;
+    REQUIRE(object == &customTicks);
+}
+
+static PIU_VTIMER_REGISTER(registeredTimerA, 1, piu_VTMode_Continuous, nullptr);
+static PIU_VTIMER_REGISTER(registeredTimerB, 3, piu_VTMode_OneShot, nullptr);
+static PIU_BUTTON_REGISTER(registeredButton, 2);
+PIU_TICK_REGISTER(registeredCustom, customTick, &customTicks);
+
+
+TEST_CASE("Tick registry test", "[tick_registry]")
+{
+    REQUIRE(piu_tickRegistry_count() == 4);
+
+    piu_VTimer_startCounter(&registeredTimerA);
+    piu_VTimer_startCounter(&registeredTimerB);
+    piu_Button_updateState(&registeredButton, true);
+
+    for (int i = 0; i < 3; ++i) { piu_tickAll(); }
+
+    REQUIRE(customTicks == 3);
+    REQUIRE(piu_VTimer_getCounter(&registeredTimerB) == 3);
+    REQUIRE_FALSE(piu_VTimer_getOverOverflow(&registeredTimerA));
+
+    piu_tickAll();
+    REQUIRE(piu_VTimer_getOverflow(&registeredTimerA));
+    REQUIRE(piu_VTimer_getOverOverflow(&registeredTimerA));
+    REQUIRE(piu_VTimer_getOverflow(&registeredTimerB));
+    REQUIRE_FALSE(piu_VTimer_getCounterActive(&registeredTimerB));
+
+    REQUIRE(piu_Button_stableState(&registeredButton));
+}
@@ -0,0 +1,106 @@
+//
+// Created by YthanZhang on 2026/10/19.
+//
+
+#include "piu_vtimer_scheduler.h"
+
+#include "catch2/catch_all.hpp"
+
+#include <algorithm>
+#include <vector>
+
+
+static piu_VTScheduler scheduler;
+static std::vector<uint32_t> expiriesA;
+static std::vector<uint32_t> expiriesB;
+
+static void callbackA() { expiriesA.push_back(scheduler.now); }
+static void callbackB() { expiriesB.push_back(scheduler.now); }
+
+
+TEST_CASE("Virtual timer scheduler test", "[vtimer_scheduler]")
+{
+    piu_VTimer timerA = PIU_VTIMER_MAKE(9, piu_VTMode_Continuous, callbackA);
+    piu_VTimer timerB = PIU_VTIMER_MAKE(11, piu_VTMode_Continuous, callbackB);
+
+    expiriesA.clear();
+    expiriesB.clear();
+
+    SECTION("no slack expires like piu_VTimer_tick")
+    {
+        piu_VTSchedEntry entries[] = {
+            PIU_VTSCHED_ENTRY(&timerA, 0),
+            PIU_VTSCHED_ENTRY(&timerB, 0),
+        };
+        piu_VTScheduler_construct(&scheduler, entries, 2);
+        piu_VTScheduler_startTimer(&scheduler, &timerA);
+        piu_VTScheduler_startTimer(&scheduler, &timerB);
+
+        for (int i = 0; i < 60; ++i) { piu_VTScheduler_tick(&scheduler); }
+
+        REQUIRE(expiriesA == std::vector<uint32_t> {10, 20, 30, 40, 50, 60});
+        REQUIRE(expiriesB == std::vector<uint32_t> {12, 24, 36, 48, 60});
+        REQUIRE(piu_VTimer_getOverflow(&timerA));
+        REQUIRE(piu_VTimer_getOverOverflow(&timerA));
+    }
+
+    SECTION("overlapping windows are coalesced")
+    {
+        piu_VTSchedEntry entries[] = {
+            PIU_VTSCHED_ENTRY(&timerA, 5),
+            PIU_VTSCHED_ENTRY(&timerB, 5),
+        };
+        piu_VTScheduler_construct(&scheduler, entries, 2);
+        piu_VTScheduler_startTimer(&scheduler, &timerA);
+        piu_VTScheduler_startTimer(&scheduler, &timerB);
+
+        for (int i = 0; i < 120; ++i) { piu_VTScheduler_tick(&scheduler); }
+
+        // every expiry lands inside its window
+        for (size_t i = 0; i < expiriesA.size(); ++i)
+        {
+            REQUIRE(expiriesA[i] >= 10 * (i + 1));
+            REQUIRE(expiriesA[i] <= 10 * (i + 1) + 5);
+        }
+        for (size_t i = 0; i < expiriesB.size(); ++i)
+        {
+            REQUIRE(expiriesB[i] >= 12 * (i + 1));
+            REQUIRE(expiriesB[i] <= 12 * (i + 1) + 5);
+        }
+
+        // and expiries are shared by both timers where windows overlap
+        std::vector<uint32_t> wakeUps = expiriesA;
+        wakeUps.insert(wakeUps.end(), expiriesB.begin(), expiriesB.end());
+        std::sort(wakeUps.begin(), wakeUps.end());
+        wakeUps.erase(std::unique(wakeUps.begin(), wakeUps.end()),
+                      wakeUps.end());
+
+        REQUIRE(piu_VTScheduler_getWakeCount(&scheduler) == wakeUps.size());
+        REQUIRE(wakeUps.size() < expiriesA.size() + expiriesB.size() - 5);
+    }
+
+    SECTION("one shot, stop and tickless advance")
+    {
+        piu_VTimer_setTimerMode(&timerA, piu_VTMode_OneShot);
+        piu_VTSchedEntry entries[] = {
+            PIU_VTSCHED_ENTRY(&timerA, 0),
+            PIU_VTSCHED_ENTRY(&timerB, 0),
+        };
+        piu_VTScheduler_construct(&scheduler, entries, 2);
+        REQUIRE(piu_VTScheduler_ticksToWake(&scheduler) == UINT32_MAX);
+
+        piu_VTScheduler_startTimer(&scheduler, &timerA);
+        piu_VTScheduler_startTimer(&scheduler, &timerB);
+        REQUIRE(piu_VTScheduler_ticksToWake(&scheduler) == 10);
+
+        REQUIRE(piu_VTScheduler_advance(&scheduler, 100) == 10);
+        REQUIRE(expiriesA == std::vector<uint32_t> {10});
+        REQUIRE_FALSE(piu_VTimer_getCounterActive(&timerA));
+        REQUIRE(piu_VTScheduler_ticksToWake(&scheduler) == 2);
+
+        piu_VTScheduler_stopTimer(&scheduler, &timerB);
+        REQUIRE(piu_VTScheduler_ticksToWake(&scheduler) == UINT32_MAX);
+        REQUIRE(piu_VTScheduler_advance(&scheduler, 100) == 100);
+        REQUIRE(expiriesB.empty());
+    }
+}
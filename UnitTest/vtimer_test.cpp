@@ -3,6 +3,7 @@
 //
 
 #include "piu_vtimer.h"
+#include "piu_vtimer_width.h"
 
 #include "catch2/catch_all.hpp"
 
@@ -89,3 +90,72 @@ TEST_CASE("Virtual timer test", "[vtimer]")
         REQUIRE(flag_callback);
     }
 }
+
+
+TEST_CASE("Virtual timer width test", "[vtimer]")
+{
+    SECTION("8 bits timer")
+    {
+        piu_VTimer8 vtimer8 = PIU_VTIMER_MAKE(UINT8_MAX,
+                                              piu_VTMode_OneShot,
+                                              nullptr);
+        // Narrower counters leave less before the mode and flags. Pointer
+        // alignment pads both to 16 bytes on 64 bits hosts, with 4 bytes
+        // pointers or smaller the struct itself is smaller
+        REQUIRE(offsetof(piu_VTimer8, timerMode) <
+                offsetof(piu_VTimer, timerMode));
+        REQUIRE(offsetof(piu_VTimer, timerMode) <
+                offsetof(piu_VTimer32, timerMode));
+        if (alignof(piu_VTimer) <= 4)
+        {
+            REQUIRE(sizeof(vtimer8) < sizeof(piu_VTimer));
+        }
+        REQUIRE(sizeof(vtimer8) < sizeof(piu_VTimer32));
+
+        piu_VTimer8_startCounter(&vtimer8);
+        for (uint16_t i = 0; i < UINT8_MAX; ++i)
+        {
+            piu_VTimer8_tick(&vtimer8);
+        }
+        REQUIRE(piu_VTimer8_getCounter(&vtimer8) == UINT8_MAX);
+        REQUIRE_FALSE(piu_VTimer8_getOverflow(&vtimer8));
+
+        piu_VTimer8_tick(&vtimer8);    // overflow
+        REQUIRE(piu_VTimer8_getOverflow(&vtimer8));
+        REQUIRE_FALSE(piu_VTimer8_getCounterActive(&vtimer8));
+    }
+
+    SECTION("32 bits timer beyond 16 bits period")
+    {
+        piu_VTimer32 vtimer32;
+        piu_VTimer32_construct(&vtimer32,
+                               100000,
+                               piu_VTMode_Continuous,
+                               callback);
+        piu_VTimer32_startCounter(&vtimer32);
+
+        flag_callback = false;
+        for (uint32_t i = 0; i < 100000; ++i) { piu_VTimer32_tick(&vtimer32); }
+        REQUIRE(piu_VTimer32_getCounter(&vtimer32) == 100000);
+        REQUIRE_FALSE(flag_callback);
+
+        piu_VTimer32_tick(&vtimer32);    // overflow
+        REQUIRE(flag_callback);
+        REQUIRE(piu_VTimer32_getOverflow(&vtimer32));
+        REQUIRE(piu_VTimer32_getCounterActive(&vtimer32));
+        REQUIRE(piu_VTimer32_getCounter(&vtimer32) == 0);
+    }
+
+    SECTION("64 bits timer")
+    {
+        piu_VTimer64 vtimer64;
+        piu_VTimer64_construct(&vtimer64, 2, piu_VTMode_OneShot, nullptr);
+        piu_VTimer64_setCounterReloadValue(&vtimer64, UINT64_MAX);
+        REQUIRE(piu_VTimer64_getCounterReloadValue(&vtimer64) == UINT64_MAX);
+
+        piu_VTimer64_startCounter(&vtimer64);
+        piu_VTimer64_tick(&vtimer64);
+        REQUIRE(piu_VTimer64_stopCounter(&vtimer64) == 1);
+        REQUIRE(piu_VTimer64_resetCounter(&vtimer64) == 0);
+    }
+}
@@ -0,0 +1,63 @@
+//
+// Created by YthanZhang on 2026/10/19.
+//
+/*******************************************************************************
+ * Copyright 2021 Ythan(Ethan) Zhang
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************
+ * This software component is licensed by Ythan Zhang under the
+ *                           BSD-2-Clause license.
+ * You may not use this file except in compliance with the license.
+ * You may obtain a copy of the License at: opensource.org/licenses/BSD-2-Clause
+ ******************************************************************************/
+
+
+/*******************************************************************************
+ * @file piu_atomic.h
+ *
+ * Thin wrapper that lets a struct holding atomic members be shared between C11
+ * translation units and C++ translation units. @n
+ *
+ * C sees <b>_Atomic(T)</b>, C++ sees <b>std::atomic<T></b>, both have the same
+ * size and alignment for the integral and pointer types used in this library.
+ * @n
+ *
+ * @note Only headers of host side (multi-threaded) utilities include this
+ *  file, the translation units using it must be compiled as C11 or newer.
+ */
+
+
+#ifndef PIU_ATOMIC_H
+#define PIU_ATOMIC_H
+
+
+#ifdef __cplusplus
+#include <atomic>
+#define PIU_ATOMIC(TYPE) std::atomic<TYPE>
+#else
+#include <stdatomic.h>
+#define PIU_ATOMIC(TYPE) _Atomic(TYPE)
+#endif
+
+
+#endif    // PIU_ATOMIC_H
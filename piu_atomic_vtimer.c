@@ -0,0 +1,226 @@
+//
+// Created by YthanZhang on 2026/10/19.
+//
+/*******************************************************************************
+ * Copyright 2021 Ythan(Ethan) Zhang
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************
+ * This software component is licensed by Ythan Zhang under the
+ *                           BSD-2-Clause license.
+ * You may not use this file except in compliance with the license.
+ * You may obtain a copy of the License at: opensource.org/licenses/BSD-2-Clause
+ ******************************************************************************/
+
+
+#include "piu_atomic_vtimer.h"
+
+
+#define COUNTER_MASK      PIU_ATOMIC_VTIMER_COUNTER_MASK
+#define FLAG_ACTIVE       PIU_ATOMIC_VTIMER_FLAG_ACTIVE
+#define FLAG_OVERFLOW     PIU_ATOMIC_VTIMER_FLAG_OVERFLOW
+#define FLAG_OVEROVERFLOW PIU_ATOMIC_VTIMER_FLAG_OVEROVERFLOW
+#define RELOAD_MASK       PIU_ATOMIC_VTIMER_RELOAD_MASK
+#define MODE_CONTINUOUS   PIU_ATOMIC_VTIMER_MODE_CONTINUOUS
+
+
+piu_AtomicVTimer* piu_AtomicVTimer_construct(piu_AtomicVTimer* vTimer,
+                                             uint16_t counterReloadValue,
+                                             piu_VTMode timerMode,
+                                             void (*callbackFunc)(void))
+{
+    atomic_init(&vTimer->config,
+                (uint32_t)counterReloadValue |
+                    (timerMode == piu_VTMode_Continuous ? MODE_CONTINUOUS
+                                                        : 0u));
+    atomic_init(&vTimer->callback, callbackFunc);
+    atomic_init(&vTimer->state, 0u);
+
+    return vTimer;
+}
+
+
+void piu_AtomicVTimer_tick(piu_AtomicVTimer* vTimer)
+{
+    const uint32_t config =
+        atomic_load_explicit(&vTimer->config, memory_order_relaxed);
+
+    uint32_t state = atomic_load_explicit(&vTimer->state, memory_order_relaxed);
+    uint32_t newState;
+    bool overflow;
+
+    do
+    {
+        // only tick if counter is active
+        if (!(state & FLAG_ACTIVE))
+        {
+            return;
+        }
+
+        overflow = (state & COUNTER_MASK) >= (config & RELOAD_MASK);
+        if (overflow)
+        {
+            newState = (state & ~COUNTER_MASK) | FLAG_OVERFLOW;
+            if (state & FLAG_OVERFLOW)
+            {
+                newState |= FLAG_OVEROVERFLOW;
+            }
+            if (!(config & MODE_CONTINUOUS))
+            {
+                newState &= ~FLAG_ACTIVE;
+            }
+        }
+        else
+        {
+            newState = state + 1;
+        }
+    } while (!atomic_compare_exchange_weak_explicit(&vTimer->state,
+                                                    &state,
+                                                    newState,
+                                                    memory_order_acq_rel,
+                                                    memory_order_relaxed));
+
+    if (overflow)
+    {
+        piu_AtomicVTimerCallback callback =
+            atomic_load_explicit(&vTimer->callback, memory_order_acquire);
+        if (callback != NULL)
+        {
+            callback();
+        }
+    }
+}
+
+
+uint16_t piu_AtomicVTimer_setCounterReloadValue(piu_AtomicVTimer* vTimer,
+                                                uint16_t counterReloadValue)
+{
+    uint32_t config =
+        atomic_load_explicit(&vTimer->config, memory_order_relaxed);
+    while (!atomic_compare_exchange_weak_explicit(
+        &vTimer->config,
+        &config,
+        (config & ~RELOAD_MASK) | counterReloadValue,
+        memory_order_release,
+        memory_order_relaxed))
+        ;
+
+    return counterReloadValue;
+}
+
+piu_VTMode piu_AtomicVTimer_setTimerMode(piu_AtomicVTimer* vTimer,
+                                         piu_VTMode timerMode)
+{
+    if (timerMode == piu_VTMode_Continuous)
+    {
+        atomic_fetch_or_explicit(&vTimer->config,
+                                 MODE_CONTINUOUS,
+                                 memory_order_release);
+    }
+    else
+    {
+        atomic_fetch_and_explicit(&vTimer->config,
+                                  ~MODE_CONTINUOUS,
+                                  memory_order_release);
+    }
+    return timerMode;
+}
+
+void piu_AtomicVTimer_setCallback(piu_AtomicVTimer* vTimer,
+                                  void (*callbackFunc)(void))
+{
+    if (!piu_AtomicVTimer_getCounterActive(vTimer))
+    {
+        atomic_store_explicit(&vTimer->callback,
+                              callbackFunc,
+                              memory_order_release);
+    }
+}
+
+
+uint16_t piu_AtomicVTimer_startCounter(piu_AtomicVTimer* vTimer)
+{
+    return (uint16_t)(atomic_fetch_or_explicit(&vTimer->state,
+                                               FLAG_ACTIVE,
+                                               memory_order_acq_rel) &
+                      COUNTER_MASK);
+}
+
+uint16_t piu_AtomicVTimer_stopCounter(piu_AtomicVTimer* vTimer)
+{
+    return (uint16_t)(atomic_fetch_and_explicit(&vTimer->state,
+                                                ~FLAG_ACTIVE,
+                                                memory_order_acq_rel) &
+                      COUNTER_MASK);
+}
+
+uint16_t piu_AtomicVTimer_resetCounter(piu_AtomicVTimer* vTimer)
+{
+    atomic_fetch_and_explicit(&vTimer->state,
+                              ~COUNTER_MASK,
+                              memory_order_acq_rel);
+    return 0;
+}
+
+uint16_t piu_AtomicVTimer_getCounter(piu_AtomicVTimer* vTimer)
+{
+    return (uint16_t)(atomic_load_explicit(&vTimer->state,
+                                           memory_order_acquire) &
+                      COUNTER_MASK);
+}
+
+uint16_t piu_AtomicVTimer_getCounterReloadValue(piu_AtomicVTimer* vTimer)
+{
+    return (uint16_t)(atomic_load_explicit(&vTimer->config,
+                                           memory_order_acquire) &
+                      RELOAD_MASK);
+}
+
+
+bool piu_AtomicVTimer_getOverflow(piu_AtomicVTimer* vTimer)
+{
+    return atomic_fetch_and_explicit(&vTimer->state,
+                                     ~FLAG_OVERFLOW,
+                                     memory_order_acq_rel) &
+           FLAG_OVERFLOW;
+}
+
+bool piu_AtomicVTimer_getOverOverflow(piu_AtomicVTimer* vTimer)
+{
+    return atomic_load_explicit(&vTimer->state, memory_order_acquire) &
+           FLAG_OVEROVERFLOW;
+}
+
+bool piu_AtomicVTimer_getCounterActive(piu_AtomicVTimer* vTimer)
+{
+    return atomic_load_explicit(&vTimer->state, memory_order_acquire) &
+           FLAG_ACTIVE;
+}
+
+
+bool piu_AtomicVTimer_clearOverOverflow(piu_AtomicVTimer* vTimer)
+{
+    return atomic_fetch_and_explicit(&vTimer->state,
+                                     ~FLAG_OVEROVERFLOW,
+                                     memory_order_acq_rel) &
+           FLAG_OVEROVERFLOW;
+}
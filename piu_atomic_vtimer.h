@@ -0,0 +1,253 @@
+//
+// Created by YthanZhang on 2026/10/19.
+//
+/*******************************************************************************
+ * Copyright 2021 Ythan(Ethan) Zhang
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************
+ * This software component is licensed by Ythan Zhang under the
+ *                           BSD-2-Clause license.
+ * You may not use this file except in compliance with the license.
+ * You may obtain a copy of the License at: opensource.org/licenses/BSD-2-Clause
+ ******************************************************************************/
+
+
+/*******************************************************************************
+ * @file piu_atomic_vtimer.h
+ *
+ * Thread safe variant of <b>piu_VTimer</b>, for hosts where one thread ticks
+ * the timers while other threads start, stop, reset or poll them. @n
+ *
+ * The counter and all flags are packed into a single atomic state word, so
+ * every operation is a single atomic instruction or a short compare-exchange
+ * loop, no mutex is ever taken: @n
+ *  - <b>piu_AtomicVTimer_startCounter</b>, <b>piu_AtomicVTimer_stopCounter</b>,
+ *  <b>piu_AtomicVTimer_resetCounter</b>, <b>piu_AtomicVTimer_getOverflow</b>
+ *  and <b>piu_AtomicVTimer_clearOverOverflow</b> are one atomic fetch-and-op
+ *  each, hence wait-free @n
+ *  - <b>piu_AtomicVTimer_tick</b> is a compare-exchange loop, it only retries
+ *  when another thread modified the state word in between, hence lock-free @n
+ *
+ * Behaviour is otherwise identical to <b>piu_VTimer</b>, see piu_vtimer.h.
+ *
+ * @note <b>piu_AtomicVTimer_tick</b> should only be called from one thread,
+ *  the callback function is called from that thread.
+ * @note The translation unit is compiled as C11, the target must provide
+ *  lock-free 32 bits atomics (or libatomic) to link it.
+ */
+
+
+#ifndef PIU_ATOMIC_VTIMER_H
+#define PIU_ATOMIC_VTIMER_H
+
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "piu_atomic.h"
+#include "piu_vtimer.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+#define PIU_ATOMIC_VTIMER_COUNTER_MASK      0x0000FFFFu
+#define PIU_ATOMIC_VTIMER_FLAG_ACTIVE       0x00010000u
+#define PIU_ATOMIC_VTIMER_FLAG_OVERFLOW     0x00020000u
+#define PIU_ATOMIC_VTIMER_FLAG_OVEROVERFLOW 0x00040000u
+
+#define PIU_ATOMIC_VTIMER_RELOAD_MASK     0x0000FFFFu
+#define PIU_ATOMIC_VTIMER_MODE_CONTINUOUS 0x00010000u
+
+
+typedef void (*piu_AtomicVTimerCallback)(void);
+
+
+/**
+ * @warning All data contained in this struct should be considered private and
+ *      should only be accessed with functions starting with
+ *      <b>piu_AtomicVTimer_</b>
+ */
+typedef struct piu_struct_AtomicVTimer
+{
+    // counter reload value | timer mode
+    PIU_ATOMIC(uint32_t) config;
+
+    PIU_ATOMIC(piu_AtomicVTimerCallback) callback;
+
+    // counter | active flag | overflow flag | over overflow flag
+    PIU_ATOMIC(uint32_t) state;
+} piu_AtomicVTimer;
+
+
+/**
+ * @brief Use this macro to create a piu_AtomicVTimer struct
+ * @note A piu_AtomicVTimer struct created with this macro doesn't need to call
+ *      <b>piu_AtomicVTimer_construct</b>
+ * @param RELOAD_VALUE A counter reload is triggered when the counter
+ *      reaches this value
+ * @param TIMER_MODE Should timer stop after one overflow or be continuous, see
+ *      piu_VTMode
+ * @param CALLBACK_FUNC The callback function piu_AtomicVTimer_tick will call on
+ *      overflow event, set to @p NULL for no callback
+ */
+#define PIU_ATOMIC_VTIMER_MAKE(RELOAD_VALUE, TIMER_MODE, CALLBACK_FUNC)        \
+    {                                                                          \
+        (((uint32_t)(RELOAD_VALUE)&PIU_ATOMIC_VTIMER_RELOAD_MASK) |            \
+         ((TIMER_MODE) == piu_VTMode_Continuous                                \
+              ? PIU_ATOMIC_VTIMER_MODE_CONTINUOUS                              \
+              : 0u)),                                                          \
+            (CALLBACK_FUNC), 0u,                                               \
+    }
+
+/**
+ * @brief Use this function to initialized a piu_AtomicVTimer struct
+ * @note Only need to call this function if the struct was not created with
+ *      <b>PIU_ATOMIC_VTIMER_MAKE</b>
+ * @warning Not thread safe, the struct must not be shared before this
+ *      function returns
+ * @param vTimer Pointer to an uninitialized piu_AtomicVTimer struct
+ * @param counterReloadValue A counter reload is triggered when the counter
+ *      reaches this value
+ * @param timerMode Should timer stop after one overflow or be continuous, see
+ *      piu_VTMode
+ * @param callbackFunc The callback function piu_AtomicVTimer_tick will call on
+ *      overflow event, set to @p NULL for no callback
+ * @return Pointer to the same piu_AtomicVTimer struct passed in
+ */
+piu_AtomicVTimer* piu_AtomicVTimer_construct(piu_AtomicVTimer* vTimer,
+                                             uint16_t counterReloadValue,
+                                             piu_VTMode timerMode,
+                                             void (*callbackFunc)(void));
+
+/**
+ * @brief Should call this function for timer update, preferably with a
+ *      consistent interval
+ * @note Must only be called from a single (ticker) thread
+ * @param vTimer Pointer to a piu_AtomicVTimer struct
+ */
+void piu_AtomicVTimer_tick(piu_AtomicVTimer* vTimer);
+
+/**
+ * @brief Use this function to set new counter reload value
+ * @param vTimer Pointer to a piu_AtomicVTimer struct
+ * @param counterReloadValue New counter reload value
+ * @return The counter reload value
+ */
+uint16_t piu_AtomicVTimer_setCounterReloadValue(piu_AtomicVTimer* vTimer,
+                                                uint16_t counterReloadValue);
+/**
+ * @brief Use this function to set time to be in one shot mode or in continuous
+ *      mode
+ * @param vTimer Pointer to a piu_AtomicVTimer struct
+ * @param timerMode New timer mode
+ * @return The timer mode
+ */
+piu_VTMode piu_AtomicVTimer_setTimerMode(piu_AtomicVTimer* vTimer,
+                                         piu_VTMode timerMode);
+/**
+ * @brief Use this function to set callback function on counter overflow
+ * @warning A new callback can only be set when counter is not active. If called
+ *      when counter is active, the callback function will <b>NOT</b> change
+ * @param vTimer Pointer to a piu_AtomicVTimer struct
+ * @param callbackFunc Pointer to new callback function, use @p NULL to disable
+ *      callback
+ */
+void piu_AtomicVTimer_setCallback(piu_AtomicVTimer* vTimer,
+                                  void (*callbackFunc)(void));
+
+/**
+ * @brief Start counter, have no effect if counter already active
+ * @note Wait-free
+ * @param vTimer Pointer to a piu_AtomicVTimer struct
+ * @return The current counter value
+ */
+uint16_t piu_AtomicVTimer_startCounter(piu_AtomicVTimer* vTimer);
+/**
+ * @brief Stop counter, have no effect if counter is not active
+ * @note Wait-free
+ * @param vTimer Pointer to a piu_AtomicVTimer struct
+ * @return The current counter value
+ */
+uint16_t piu_AtomicVTimer_stopCounter(piu_AtomicVTimer* vTimer);
+/**
+ * @brief Reset counter to 0
+ * @note Wait-free
+ * @param vTimer Pointer to a piu_AtomicVTimer struct
+ * @return The counter value after reset, always 0
+ */
+uint16_t piu_AtomicVTimer_resetCounter(piu_AtomicVTimer* vTimer);
+/**
+ * @brief Get the current counter value
+ * @param vTimer Pointer to a piu_AtomicVTimer struct
+ * @return The counter value
+ */
+uint16_t piu_AtomicVTimer_getCounter(piu_AtomicVTimer* vTimer);
+/**
+ * @brief Get the counter reload value
+ * @param vTimer Pointer to a piu_AtomicVTimer struct
+ * @return The counter reload value
+ */
+uint16_t piu_AtomicVTimer_getCounterReloadValue(piu_AtomicVTimer* vTimer);
+
+/**
+ * @brief Get overflow flag
+ * @note The flag will be cleared atomically when this function is called, an
+ *      overflow is reported to exactly one caller
+ * @note Wait-free
+ * @param vTimer Pointer to a piu_AtomicVTimer struct
+ * @return @p true if there were an overflow since the last call, else return @p
+ *      false
+ */
+bool piu_AtomicVTimer_getOverflow(piu_AtomicVTimer* vTimer);
+/**
+ * @brief Get over overflow flag
+ * @param vTimer Pointer to a piu_AtomicVTimer struct
+ * @return @p true if there were an over overflow, else return @p false
+ */
+bool piu_AtomicVTimer_getOverOverflow(piu_AtomicVTimer* vTimer);
+/**
+ * @brief Check if counter/timer is currently active
+ * @param vTimer Pointer to a piu_AtomicVTimer struct
+ * @return @p true if counter/timer is active, else return @p false
+ */
+bool piu_AtomicVTimer_getCounterActive(piu_AtomicVTimer* vTimer);
+
+/**
+ * @brief Clear over overflow flag
+ * @note Wait-free
+ * @param vTimer Pointer to a piu_AtomicVTimer struct
+ * @return @p true if the over overflow flag was set prior to the call of this
+ *      function, else return @p false
+ */
+bool piu_AtomicVTimer_clearOverOverflow(piu_AtomicVTimer* vTimer);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif    // PIU_ATOMIC_VTIMER_H
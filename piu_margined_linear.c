@@ -35,10 +35,13 @@
 #include "piu_margined_linear.h"
 
 #include <stdbool.h>
+#include <stddef.h>
 
+#include "piu_modbus_crc16.h"
 #include "piu_number.h"
 
 
+#ifndef PIU_MARGINED_LINEAR_FIXED_POINT
 static float calcLinear(uint16_t highFlatVal,
                         uint16_t lowFlatVal,
                         uint16_t highLinearPoint,
@@ -47,6 +50,180 @@ static float calcLinear(uint16_t highFlatVal,
     return ((float)highFlatVal - (float)lowFlatVal) /
            ((float)highLinearPoint - (float)lowLinearPoint);
 }
+#endif
+
+// Slope magnitude in Q16.16, rounded to nearest
+static uint32_t calcLinearQ16(uint16_t highFlatVal,
+                              uint16_t lowFlatVal,
+                              uint16_t highLinearPoint,
+                              uint16_t lowLinearPoint)
+{
+    const uint32_t dy = highFlatVal >= lowFlatVal
+                            ? (uint32_t)(highFlatVal - lowFlatVal)
+                            : (uint32_t)(lowFlatVal - highFlatVal);
+    const uint32_t dx = (uint32_t)(highLinearPoint - lowLinearPoint);
+    if (dx == 0)
+    {
+        return 0;    // No linear section
+    }
+    return (uint32_t)((((uint64_t)dy << 16) + dx / 2) / dx);
+}
+
+static inline uint16_t linearYFixed(const piu_MarginedLinear* marginedLinear,
+                                    uint16_t x)
+{
+    // One 32x32->64 multiply and a shift, truncated toward zero like the
+    // float path
+    const uint64_t product = (uint64_t)marginedLinear->linearRateQ16 *
+                             (uint32_t)(x - marginedLinear->xLinearLow);
+
+    if (marginedLinear->flag_linearFalling)
+    {
+        return (uint16_t)(marginedLinear->yLowFlat -
+                          (uint32_t)((product + 0xFFFF) >> 16));
+    }
+    return (uint16_t)(marginedLinear->yLowFlat + (uint32_t)(product >> 16));
+}
+
+static inline uint16_t linearY(const piu_MarginedLinear* marginedLinear,
+                               uint16_t x)
+{
+#ifdef PIU_MARGINED_LINEAR_FIXED_POINT
+    return linearYFixed(marginedLinear, x);
+#else
+    return (uint16_t)((marginedLinear->linearRate *
+                       (float)(x - marginedLinear->xLinearLow)) +
+                      (float)marginedLinear->yLowFlat);
+#endif
+}
+
+static void updateLinearRate(piu_MarginedLinear* marginedLinear)
+{
+#ifndef PIU_MARGINED_LINEAR_FIXED_POINT
+    marginedLinear->linearRate = calcLinear(marginedLinear->yHighFlat,
+                                            marginedLinear->yLowFlat,
+                                            marginedLinear->xLinearHigh,
+                                            marginedLinear->xLinearLow);
+#else
+    marginedLinear->linearRate = 0;
+#endif
+    marginedLinear->linearRateQ16 = calcLinearQ16(marginedLinear->yHighFlat,
+                                                  marginedLinear->yLowFlat,
+                                                  marginedLinear->xLinearHigh,
+                                                  marginedLinear->xLinearLow);
+    marginedLinear->flag_linearFalling =
+        marginedLinear->yHighFlat < marginedLinear->yLowFlat;
+
+    marginedLinear->flag_lutDirty = true;
+}
+
+// Output steps of the linear section, at most the y distance of its ends
+static uint16_t lutSteps(const piu_MarginedLinear* marginedLinear)
+{
+    return marginedLinear->yHighFlat >= marginedLinear->yLowFlat
+               ? marginedLinear->yHighFlat - marginedLinear->yLowFlat
+               : marginedLinear->yLowFlat - marginedLinear->yHighFlat;
+}
+
+// Step form when the section has fewer output steps than inputs
+static bool lutStepForm(const piu_MarginedLinear* marginedLinear)
+{
+    return lutSteps(marginedLinear) <
+           marginedLinear->xLinearHigh - marginedLinear->xLinearLow;
+}
+
+// Number of table entries the linear section needs
+static uint16_t lutEntries(const piu_MarginedLinear* marginedLinear)
+{
+    if (lutStepForm(marginedLinear))
+    {
+        return lutSteps(marginedLinear);
+    }
+    return marginedLinear->xLinearHigh - marginedLinear->xLinearLow;
+}
+
+static bool lutReady(const piu_MarginedLinear* marginedLinear)
+{
+    return marginedLinear->lut != NULL && !marginedLinear->flag_lutDirty &&
+           marginedLinear->flag_lutReady;
+}
+
+// Linear section output from the step form, the steps are ascending input
+// offsets from xLinearLow + 1, branchless count of the steps at or below
+static uint16_t lutStepY(const piu_MarginedLinear* marginedLinear,
+                         uint16_t offset)
+{
+    const uint16_t* steps = marginedLinear->lut;
+    const uint16_t* base  = steps;
+    uint16_t len          = marginedLinear->lutCount;
+    uint16_t passed       = 0;
+    if (len != 0)
+    {
+        while (len > 1)
+        {
+            const uint16_t half = len / 2;
+            base += (base[half] <= offset) ? half : 0;
+            len -= half;
+        }
+        passed = (uint16_t)((base - steps) + (*base <= offset));
+    }
+
+    return marginedLinear->flag_linearFalling
+               ? (uint16_t)(marginedLinear->lutFirstY - passed)
+               : (uint16_t)(marginedLinear->lutFirstY + passed);
+}
+
+static void updateLUT(piu_MarginedLinear* marginedLinear)
+{
+    if (marginedLinear->lut == NULL || !marginedLinear->flag_lutDirty)
+    {
+        return;
+    }
+    marginedLinear->flag_lutDirty = false;
+    marginedLinear->flag_lutSteps = lutStepForm(marginedLinear);
+    marginedLinear->flag_lutReady = false;
+    marginedLinear->lutCount      = 0;
+
+    const uint16_t count = lutEntries(marginedLinear);
+    if (count > marginedLinear->lutCapacity)
+    {
+        return;
+    }
+
+    const uint16_t xFirst = marginedLinear->xLinearLow + 1;
+    if (!marginedLinear->flag_lutSteps)
+    {
+        for (uint16_t i = 0; i < count; ++i)
+        {
+            marginedLinear->lut[i] = linearY(marginedLinear, xFirst + i);
+        }
+        marginedLinear->lutCount = count;
+        marginedLinear->flag_lutReady = true;
+        return;
+    }
+
+    // Less than one output per input, consecutive outputs differ by at most 1
+    const uint16_t width = marginedLinear->xLinearHigh - xFirst;
+    uint16_t y           = linearY(marginedLinear, xFirst);
+    marginedLinear->lutFirstY = y;
+    for (uint16_t offset = 1; offset <= width; ++offset)
+    {
+        const uint16_t next = linearY(marginedLinear, xFirst + offset);
+        if (next == y)
+        {
+            continue;
+        }
+        if ((next != y + 1 && next + 1 != y) ||
+            marginedLinear->lutCount == count)
+        {
+            marginedLinear->lutCount = 0;    // Arithmetic is used instead
+            return;
+        }
+        marginedLinear->lut[marginedLinear->lutCount++] = offset;
+        y = next;
+    }
+    marginedLinear->flag_lutReady = true;
+}
 
 
 piu_MarginedLinear piu_MarginedLinear_make(uint16_t xOff,
@@ -89,6 +266,14 @@ piu_MarginedLinear* piu_MarginedLinear_construct(
     uint16_t yHighFlat,
     uint16_t yMaxFlat)
 {
+    marginedLinear->lut           = NULL;
+    marginedLinear->lutCapacity   = 0;
+    marginedLinear->lutCount      = 0;
+    marginedLinear->lutFirstY     = 0;
+    marginedLinear->flag_lutSteps = false;
+    marginedLinear->flag_lutReady = false;
+    marginedLinear->flag_lutDirty = true;
+
     piu_MarginedLinear_updateInput(marginedLinear,
                                    xOff,
                                    xOn,
@@ -114,71 +299,37 @@ uint16_t piu_MarginedLinear_setX(piu_MarginedLinear* marginedLinear,
 {
     marginedLinear->lastInput = inputVal;
 
-    while (true)
+    const uint32_t state = marginedLinear->currentState;
+    if (state > piu_MarginState_MaxFlat)
     {
-        switch (marginedLinear->currentState)
-        {
-        case (piu_MarginState_Off): {
-            if (inputVal > marginedLinear->xOn)
-            {
-                marginedLinear->currentState = piu_MarginState_LowFlat;
-                continue;
-            }
-            break;
-        }
-        case (piu_MarginState_LowFlat): {
-            if (inputVal > marginedLinear->xLinearLow)
-            {
-                marginedLinear->currentState = piu_MarginState_Linear;
-                continue;
-            }
-            else if (inputVal <= marginedLinear->xOff)
-            {
-                marginedLinear->currentState = piu_MarginState_Off;
-                continue;
-            }
-            break;
-        }
-        case (piu_MarginState_Linear): {
-            if (inputVal > marginedLinear->xLinearHigh)
-            {
-                marginedLinear->currentState = piu_MarginState_HighFlat;
-                continue;
-            }
-            else if (inputVal <= marginedLinear->xLinearLow)
-            {
-                marginedLinear->currentState = piu_MarginState_LowFlat;
-                continue;
-            }
-            break;
-        }
-        case (piu_MarginState_HighFlat): {
-            if (inputVal > marginedLinear->xStepUp)
-            {
-                marginedLinear->currentState = piu_MarginState_MaxFlat;
-                continue;
-            }
-            else if (inputVal <= marginedLinear->xLinearHigh)
-            {
-                marginedLinear->currentState = piu_MarginState_Linear;
-                continue;
-            }
-            break;
-        }
-        case (piu_MarginState_MaxFlat): {
-            if (inputVal <= marginedLinear->xStepDown)
-            {
-                marginedLinear->currentState = piu_MarginState_HighFlat;
-                continue;
-            }
-            break;
-        }
-        default: {
-            marginedLinear->currentState = piu_MarginState_Off;
-            break;
-        }
-        }
-        break;
+        marginedLinear->currentState = piu_MarginState_Off;
+        return piu_MarginedLinear_getY(marginedLinear);
+    }
+
+    // The rising thresholds (xOn, xLinearLow, xLinearHigh, xStepUp) and the
+    // falling ones (xOff, xLinearLow, xLinearHigh, xStepDown) are both sorted,
+    // so the number of thresholds below the input is the section it would
+    // reach stepping the state machine one transition at a time. The state
+    // only rises to the rising count and only falls to the falling count,
+    // rising <= falling, so the target is max(min(state, falling), rising).
+    // Compares sum to setcc/adc without branches.
+    const uint32_t rising = (uint32_t)(inputVal > marginedLinear->xOn) +
+                            (uint32_t)(inputVal > marginedLinear->xLinearLow) +
+                            (uint32_t)(inputVal > marginedLinear->xLinearHigh) +
+                            (uint32_t)(inputVal > marginedLinear->xStepUp);
+    const uint32_t falling =
+        (uint32_t)(inputVal > marginedLinear->xOff) +
+        (uint32_t)(inputVal > marginedLinear->xLinearLow) +
+        (uint32_t)(inputVal > marginedLinear->xLinearHigh) +
+        (uint32_t)(inputVal > marginedLinear->xStepDown);
+
+    const uint32_t lower = state < falling ? state : falling;
+    marginedLinear->currentState =
+        (piu_MarginSection)(lower > rising ? lower : rising);
+
+    if (marginedLinear->currentState == piu_MarginState_Linear)
+    {
+        updateLUT(marginedLinear);
     }
 
     return piu_MarginedLinear_getY(marginedLinear);
@@ -195,10 +346,23 @@ uint16_t piu_MarginedLinear_getY(const piu_MarginedLinear* marginedLinear)
         return marginedLinear->yLowFlat;
     }
     case (piu_MarginState_Linear): {
-        return (uint16_t)((marginedLinear->linearRate *
-                           (float)(marginedLinear->lastInput -
-                                   marginedLinear->xLinearLow)) +
-                          (float)marginedLinear->yLowFlat);
+        if (lutReady(marginedLinear))
+        {
+            // Wraps to a large index when the input is below the section
+            const uint16_t index = (uint16_t)(marginedLinear->lastInput -
+                                              marginedLinear->xLinearLow - 1);
+            if (marginedLinear->flag_lutSteps &&
+                index < marginedLinear->xLinearHigh - marginedLinear->xLinearLow)
+            {
+                return lutStepY(marginedLinear, index);
+            }
+            if (!marginedLinear->flag_lutSteps &&
+                index < marginedLinear->lutCount)
+            {
+                return marginedLinear->lut[index];
+            }
+        }
+        return linearY(marginedLinear, marginedLinear->lastInput);
     }
     case (piu_MarginState_HighFlat): {
         return marginedLinear->yHighFlat;
@@ -212,6 +376,304 @@ uint16_t piu_MarginedLinear_getY(const piu_MarginedLinear* marginedLinear)
     }
 }
 
+uint16_t piu_MarginedLinear_getYFixed(const piu_MarginedLinear* marginedLinear)
+{
+    if (marginedLinear->currentState != piu_MarginState_Linear)
+    {
+        return piu_MarginedLinear_getY(marginedLinear);
+    }
+    return linearYFixed(marginedLinear, marginedLinear->lastInput);
+}
+
+
+// Inclusive input range that keeps the state machine in its current section
+static void sectionRange(const piu_MarginedLinear* marginedLinear,
+                         uint32_t* low,
+                         uint32_t* high)
+{
+    switch (marginedLinear->currentState)
+    {
+    case (piu_MarginState_Off): {
+        *low  = 0;
+        *high = marginedLinear->xOn;
+        break;
+    }
+    case (piu_MarginState_LowFlat): {
+        *low  = (uint32_t)marginedLinear->xOff + 1;
+        *high = marginedLinear->xLinearLow;
+        break;
+    }
+    case (piu_MarginState_Linear): {
+        *low  = (uint32_t)marginedLinear->xLinearLow + 1;
+        *high = marginedLinear->xLinearHigh;
+        break;
+    }
+    case (piu_MarginState_HighFlat): {
+        *low  = (uint32_t)marginedLinear->xLinearHigh + 1;
+        *high = marginedLinear->xStepUp;
+        break;
+    }
+    case (piu_MarginState_MaxFlat): {
+        *low  = (uint32_t)marginedLinear->xStepDown + 1;
+        *high = UINT16_MAX;
+        break;
+    }
+    default: {    // Empty range, every input goes through setX
+        *low  = 1;
+        *high = 0;
+        break;
+    }
+    }
+}
+
+// Samples tested per step when looking for the end of a run
+#define RUN_BLOCK 32
+
+// First input at or after i outside [low, high], count if none. Each block of
+// RUN_BLOCK inputs costs one branch, the range compares are ORed together
+// without branches so the compiler can vectorize them
+static size_t runEnd(const uint16_t* in,
+                     size_t i,
+                     size_t count,
+                     uint32_t low,
+                     uint32_t high)
+{
+    if (low > high)
+    {
+        return i;
+    }
+
+    // One unsigned compare per input, inputs below low wrap above width
+    const uint16_t base  = (uint16_t)low;
+    const uint16_t width = (uint16_t)(high - low);
+    while (i + RUN_BLOCK <= count)
+    {
+        uint16_t outside = 0;
+        for (uint8_t k = 0; k < RUN_BLOCK; ++k)
+        {
+            outside |= (uint16_t)(in[i + k] - base) > width ? 0xFFFF : 0;
+        }
+        if (outside)
+        {
+            break;
+        }
+        i += RUN_BLOCK;
+    }
+    while (i < count && (uint16_t)(in[i] - base) <= width) { ++i; }
+    return i;
+}
+
+// Outputs of a run of inputs inside the linear section, simple loops without
+// branches so the compiler can vectorize them
+static void linearRun(const piu_MarginedLinear* marginedLinear,
+                      const uint16_t* in,
+                      uint16_t* out,
+                      size_t count)
+{
+    const uint16_t xLow = marginedLinear->xLinearLow;
+    const uint16_t yLow = marginedLinear->yLowFlat;
+
+    // Inputs of the run are inside (xLinearLow, xLinearHigh]
+    if (lutReady(marginedLinear) && marginedLinear->flag_lutSteps)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            out[i] = lutStepY(marginedLinear, (uint16_t)(in[i] - xLow - 1));
+        }
+        return;
+    }
+    if (lutReady(marginedLinear))
+    {
+        const uint16_t* lut = marginedLinear->lut;
+        for (size_t i = 0; i < count; ++i)
+        {
+            out[i] = lut[(uint16_t)(in[i] - xLow - 1)];
+        }
+        return;
+    }
+
+#ifdef PIU_MARGINED_LINEAR_FIXED_POINT
+    const uint64_t rate = marginedLinear->linearRateQ16;
+    if (marginedLinear->flag_linearFalling)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            const uint64_t product = rate * (uint32_t)(in[i] - xLow);
+            out[i] = (uint16_t)(yLow - (uint32_t)((product + 0xFFFF) >> 16));
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            const uint64_t product = rate * (uint32_t)(in[i] - xLow);
+            out[i] = (uint16_t)(yLow + (uint32_t)(product >> 16));
+        }
+    }
+#else
+    const float rate  = marginedLinear->linearRate;
+    const float yLowF = (float)yLow;
+    for (size_t i = 0; i < count; ++i)
+    {
+        out[i] = (uint16_t)((rate * (float)(in[i] - xLow)) + yLowF);
+    }
+#endif
+}
+
+void piu_MarginedLinear_setXBatch(piu_MarginedLinear* marginedLinear,
+                                  const uint16_t* in,
+                                  uint16_t* out,
+                                  size_t count)
+{
+    if (count == 0)
+    {
+        return;
+    }
+    const uint16_t lastInput = in[count - 1];
+
+    size_t i = 0;
+    while (i < count)
+    {
+        uint32_t low  = 0;
+        uint32_t high = 0;
+        sectionRange(marginedLinear, &low, &high);
+
+        size_t end = runEnd(in, i, count, low, high);
+
+        if (marginedLinear->currentState == piu_MarginState_Linear)
+        {
+            updateLUT(marginedLinear);
+            linearRun(marginedLinear, in + i, out + i, end - i);
+        }
+        else if (end > i)
+        {
+            const uint16_t y = piu_MarginedLinear_getY(marginedLinear);
+            for (size_t k = i; k < end; ++k) { out[k] = y; }
+        }
+
+        // The sample leaving the section goes through the state machine
+        if (end < count)
+        {
+            out[end] = piu_MarginedLinear_setX(marginedLinear, in[end]);
+            ++end;
+        }
+        i = end;
+    }
+
+    marginedLinear->lastInput = lastInput;
+}
+
+
+bool piu_MarginedLinear_setLUT(piu_MarginedLinear* marginedLinear,
+                               uint16_t* table,
+                               size_t capacity)
+{
+    if (table == NULL || capacity > UINT16_MAX)
+    {
+        capacity = table == NULL ? 0 : UINT16_MAX;
+    }
+
+    marginedLinear->lut           = table;
+    marginedLinear->lutCapacity   = (uint16_t)capacity;
+    marginedLinear->lutCount      = 0;
+    marginedLinear->flag_lutDirty = true;
+    updateLUT(marginedLinear);
+
+    return lutReady(marginedLinear);
+}
+
+size_t piu_MarginedLinear_getLUTSize(const piu_MarginedLinear* marginedLinear)
+{
+    return lutEntries(marginedLinear) * sizeof(uint16_t);
+}
+
+
+static uint8_t* putU16(uint8_t* dst, uint16_t val)
+{
+    dst[0] = (uint8_t)val;
+    dst[1] = (uint8_t)(val >> 8);
+    return dst + 2;
+}
+
+static uint16_t getU16(const uint8_t* src)
+{
+    return (uint16_t)(src[0] | (src[1] << 8));
+}
+
+size_t piu_MarginedLinear_serialize(const piu_MarginedLinear* marginedLinear,
+                                    uint8_t* blob)
+{
+    uint8_t* dst = blob;
+    *dst++       = PIU_MARGINED_LINEAR_BLOB_VERSION;
+
+    dst = putU16(dst, marginedLinear->xOff);
+    dst = putU16(dst, marginedLinear->xOn);
+    dst = putU16(dst, marginedLinear->xLinearLow);
+    dst = putU16(dst, marginedLinear->xLinearHigh);
+    dst = putU16(dst, marginedLinear->xStepDown);
+    dst = putU16(dst, marginedLinear->xStepUp);
+    dst = putU16(dst, marginedLinear->yOff);
+    dst = putU16(dst, marginedLinear->yLowFlat);
+    dst = putU16(dst, marginedLinear->yHighFlat);
+    dst = putU16(dst, marginedLinear->yMaxFlat);
+
+    putU16(dst, piu_modbus_crc16(blob, (uint8_t)(dst - blob)));
+
+    return PIU_MARGINED_LINEAR_BLOB_SIZE;
+}
+
+bool piu_MarginedLinear_deserialize(piu_MarginedLinear* marginedLinear,
+                                    const uint8_t* blob,
+                                    size_t size)
+{
+    if (size < PIU_MARGINED_LINEAR_BLOB_SIZE ||
+        blob[0] != PIU_MARGINED_LINEAR_BLOB_VERSION)
+    {
+        return false;
+    }
+    if (piu_modbus_crc16(blob, PIU_MARGINED_LINEAR_BLOB_SIZE - 2) !=
+        getU16(blob + PIU_MARGINED_LINEAR_BLOB_SIZE - 2))
+    {
+        return false;
+    }
+
+    const uint8_t* x = blob + 1;
+    const uint8_t* y = blob + 13;
+
+    // A blob from piu_MarginedLinear_serialize is always in order
+    for (uint8_t i = 2; i < 12; i += 2)
+    {
+        if (getU16(x + i) < getU16(x + i - 2))
+        {
+            return false;
+        }
+    }
+
+    marginedLinear->xOff        = getU16(x);
+    marginedLinear->xOn         = getU16(x + 2);
+    marginedLinear->xLinearLow  = getU16(x + 4);
+    marginedLinear->xLinearHigh = getU16(x + 6);
+    marginedLinear->xStepDown   = getU16(x + 8);
+    marginedLinear->xStepUp     = getU16(x + 10);
+
+    marginedLinear->yOff      = getU16(y);
+    marginedLinear->yLowFlat  = getU16(y + 2);
+    marginedLinear->yHighFlat = getU16(y + 4);
+    marginedLinear->yMaxFlat  = getU16(y + 6);
+
+    // Same end state as piu_MarginedLinear_construct
+    marginedLinear->lut           = NULL;
+    marginedLinear->lutCapacity   = 0;
+    marginedLinear->lutCount      = 0;
+    marginedLinear->flag_lutReady = false;
+    marginedLinear->lastInput     = marginedLinear->xOff;
+    marginedLinear->currentState  = piu_MarginState_Off;
+    updateLinearRate(marginedLinear);
+
+    return true;
+}
+
+
 void piu_MarginedLinear_updateInput(piu_MarginedLinear* marginedLinear,
                                     uint16_t xOff,
                                     uint16_t xOn,
@@ -254,10 +716,7 @@ void piu_MarginedLinear_updateInput(piu_MarginedLinear* marginedLinear,
     marginedLinear->xStepDown   = xStepDown;
     marginedLinear->xStepUp     = xStepUp;
 
-    marginedLinear->linearRate = calcLinear(marginedLinear->yHighFlat,
-                                            marginedLinear->yLowFlat,
-                                            xHighLinear,
-                                            xLowLinear);
+    updateLinearRate(marginedLinear);
 
     piu_MarginedLinear_setX(marginedLinear, marginedLinear->lastInput);
 }
@@ -273,10 +732,7 @@ void piu_MarginedLinear_updateOutput(piu_MarginedLinear* marginedLinear,
     marginedLinear->yHighFlat = yHighFlat;
     marginedLinear->yMaxFlat  = yMaxFlat;
 
-    marginedLinear->linearRate = calcLinear(yHighFlat,
-                                            yLowFlat,
-                                            marginedLinear->xLinearHigh,
-                                            marginedLinear->xLinearLow);
+    updateLinearRate(marginedLinear);
 }
 
 
@@ -449,10 +905,7 @@ void piu_MarginedLinear_shrinkRangeX(piu_MarginedLinear* marginedLinear,
         marginedLinear->xStepUp = marginedLinear->xStepDown;
     }
 
-    marginedLinear->linearRate = calcLinear(marginedLinear->yHighFlat,
-                                            marginedLinear->yLowFlat,
-                                            marginedLinear->xLinearHigh,
-                                            marginedLinear->xLinearLow);
+    updateLinearRate(marginedLinear);
 }
 
 
@@ -500,10 +953,7 @@ void piu_MarginedLinear_shrinkRangeY(piu_MarginedLinear* marginedLinear,
         marginedLinear->yOff = marginedLinear->yLowFlat;
     }
 
-    marginedLinear->linearRate = calcLinear(marginedLinear->yHighFlat,
-                                            marginedLinear->yLowFlat,
-                                            marginedLinear->xLinearHigh,
-                                            marginedLinear->xLinearLow);
+    updateLinearRate(marginedLinear);
 }
 
 
@@ -523,6 +973,20 @@ bool piu_MarginedLinear_remapY(piu_MarginedLinear* marginedLinear,
         return false;
     }
 
+#ifdef PIU_MARGINED_LINEAR_FIXED_POINT
+    const u32 newRange      = (u32)(newHigh - newLow);
+    const u32 originalRange = (u32)(originalHigh - originalLow);
+
+    marginedLinear->yLowFlat =
+        (u16)(((u32)(marginedLinear->yLowFlat - originalLow) * newRange +
+               originalRange / 2) / originalRange + newLow);
+    marginedLinear->yHighFlat =
+        (u16)(((u32)(marginedLinear->yHighFlat - originalLow) * newRange +
+               originalRange / 2) / originalRange + newLow);
+    marginedLinear->yMaxFlat =
+        (u16)(((u32)(marginedLinear->yMaxFlat - originalLow) * newRange +
+               originalRange / 2) / originalRange + newLow);
+#else
     const f32 rangeDiff = (f32)(newHigh - newLow) /
                           (f32)(originalHigh - originalLow);
     const f32 newLow_f32 = (f32)newLow;
@@ -536,6 +1000,9 @@ bool piu_MarginedLinear_remapY(piu_MarginedLinear* marginedLinear,
     marginedLinear->yMaxFlat =
         (u16)((f32)(marginedLinear->yMaxFlat - originalLow) * rangeDiff +
               newLow_f32 + 0.5f);
+#endif
+
+    updateLinearRate(marginedLinear);
 
     return true;
 }
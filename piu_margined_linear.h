@@ -43,8 +43,16 @@ extern "C"
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 
+/**
+ * @note Define <b>PIU_MARGINED_LINEAR_FIXED_POINT</b> when compiling the
+ *      library for targets without FPU. The linear section is then evaluated
+ *      with the Q16.16 slope only (see piu_MarginedLinear_getYFixed) and no
+ *      floating point math is used at all
+ */
+
 typedef enum enum_piu_MarginSection
 {
     piu_MarginState_Off,
@@ -77,9 +85,20 @@ typedef struct struct_piu_MarginedLinear
     uint16_t yHighFlat;
     uint16_t yMaxFlat;
 
-    float linearRate;
+    float linearRate;    // Unused with PIU_MARGINED_LINEAR_FIXED_POINT
+
+    uint32_t linearRateQ16;    // Slope magnitude in Q16.16
+    bool flag_linearFalling;
 
     uint16_t lastInput;
+
+    uint16_t* lut;    // Linear section table, NULL when LUT mode is off
+    uint16_t lutCapacity;
+    uint16_t lutCount;     // Entries in use, outputs or step inputs
+    uint16_t lutFirstY;    // Output at xLinearLow + 1, base of the step form
+    bool flag_lutSteps;    // Table holds the inputs where the output steps
+    bool flag_lutReady;    // Table fits and is used
+    bool flag_lutDirty;
 } piu_MarginedLinear;
 
 
@@ -165,12 +184,103 @@ piu_MarginedLinear* piu_MarginedLinear_construct(
 uint16_t piu_MarginedLinear_setX(piu_MarginedLinear* marginedLinear,
                                  uint16_t inputVal);
 
+/**
+ * @brief Run a stream of input values through the state machine
+ * @note Same result as calling piu_MarginedLinear_setX on every input in
+ *      order, the hysteresis state carries over between calls. Runs of inputs
+ *      that stay inside one section are evaluated in a tight loop without the
+ *      state machine, the linear section as a vectorizable multiply (and
+ *      shift with PIU_MARGINED_LINEAR_FIXED_POINT). The end of a run is
+ *      searched 32 inputs at a time with a branchless range test, only the
+ *      block where the run ends is checked input by input
+ * @param marginedLinear Pointer to a piu_MarginedLinear struct
+ * @param in Input values
+ * @param out Output values, may be the same buffer as @p in
+ * @param count Number of values
+ */
+void piu_MarginedLinear_setXBatch(piu_MarginedLinear* marginedLinear,
+                                  const uint16_t* in,
+                                  uint16_t* out,
+                                  size_t count);
+
 /**
  * @brief Get the latest output value
  * @param marginedLinear Pointer to a piu_MarginedLinear struct
  * @return The latest output value
  */
 uint16_t piu_MarginedLinear_getY(const piu_MarginedLinear* marginedLinear);
+/**
+ * @brief Get the latest output value with integer math only
+ * @note The slope is kept as a correctly rounded Q16.16 value, the linear
+ *      section costs one 32x32->64 multiply and a shift. The result is within
+ *      1 LSB of the float evaluation
+ * @param marginedLinear Pointer to a piu_MarginedLinear struct
+ * @return The latest output value
+ */
+uint16_t piu_MarginedLinear_getYFixed(
+    const piu_MarginedLinear* marginedLinear);
+
+/**
+ * @brief Enable the lookup table mode
+ * @note The flat sections are kept as their single output value, only the
+ *      linear section (xLinearLow, xLinearHigh] uses the table, in the
+ *      smaller of two forms: @n
+ *      - Steep section, one output per input value, getY is a table read @n
+ *      - Shallow section, fewer output steps than inputs, one entry per step
+ *        holding the first input of the step, getY is a branchless binary
+ *        search over the steps. A section with equal ends has no steps and
+ *        needs no entries at all. @n
+ *      The table is rebuilt lazily by the next setX after any x or y update.
+ *      If the linear section does not fit in @p capacity the output falls back
+ *      to the arithmetic evaluation, the result is the same either way.
+ * @param marginedLinear Pointer to a piu_MarginedLinear struct
+ * @param table Table storage owned by the caller, NULL to disable LUT mode
+ * @param capacity Number of uint16_t entries in @p table
+ * @return true if the current linear section fits in the table
+ */
+bool piu_MarginedLinear_setLUT(piu_MarginedLinear* marginedLinear,
+                               uint16_t* table,
+                               size_t capacity);
+/**
+ * @brief Table memory the current configuration needs in LUT mode
+ * @param marginedLinear Pointer to a piu_MarginedLinear struct
+ * @return Size in bytes of the smaller table form, 0 when the linear section
+ *      is flat
+ */
+size_t piu_MarginedLinear_getLUTSize(const piu_MarginedLinear* marginedLinear);
+
+
+/**
+ * @brief Size in bytes of a serialized piu_MarginedLinear: version, the six x
+ *      and four y values as little endian uint16, then the modbus CRC16 of
+ *      everything before it, low byte first
+ */
+#define PIU_MARGINED_LINEAR_BLOB_SIZE 23
+#define PIU_MARGINED_LINEAR_BLOB_VERSION 1
+
+/**
+ * @brief Pack the curve parameters for flash storage or a modbus transfer
+ * @note The state, last input and LUT are not stored
+ * @param marginedLinear Pointer to a piu_MarginedLinear struct
+ * @param blob Output buffer of PIU_MARGINED_LINEAR_BLOB_SIZE bytes
+ * @return Bytes written, PIU_MARGINED_LINEAR_BLOB_SIZE
+ */
+size_t piu_MarginedLinear_serialize(const piu_MarginedLinear* marginedLinear,
+                                    uint8_t* blob);
+/**
+ * @brief Construct a piu_MarginedLinear from a serialized blob
+ * @note The blob is validated in place: size, version, CRC and the ordering
+ *      of the x values. Fields are written directly with one slope
+ *      calculation, the result equals piu_MarginedLinear_construct with the
+ *      same parameters. @p marginedLinear is not touched if validation fails
+ * @param marginedLinear Pointer to a piu_MarginedLinear struct
+ * @param blob Serialized data
+ * @param size Size in bytes of @p blob
+ * @return @p true if the blob was valid and loaded
+ */
+bool piu_MarginedLinear_deserialize(piu_MarginedLinear* marginedLinear,
+                                    const uint8_t* blob,
+                                    size_t size);
 
 
 /**
@@ -0,0 +1,213 @@
+//
+// Created by YthanZhang on 2026/10/19.
+//
+/*******************************************************************************
+ * Copyright 2021 Ythan(Ethan) Zhang
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************
+ * This software component is licensed by Ythan Zhang under the
+ *                           BSD-2-Clause license.
+ * You may not use this file except in compliance with the license.
+ * You may obtain a copy of the License at: opensource.org/licenses/BSD-2-Clause
+ ******************************************************************************/
+
+
+/*******************************************************************************
+ * @file piu_margined_linear.hpp
+ *
+ * C++20 compile time piu_MarginedLinear curves. @n
+ *
+ * The thresholds and outputs are template parameters, the ordering is checked
+ *  with static_assert instead of being fixed at runtime, and the slope is
+ *  computed by the compiler. <b>setX</b> and <b>getY</b> are generated with
+ *  every constant folded in, the only runtime state is the current section.
+ *  <b>marginedLinear</b> is the same struct piu_MarginedLinear_make returns,
+ *  usable as a constexpr initializer for the C API. @n
+ *
+ * @example
+ * @code
+ *  using FanCurve = piu::MarginedLinearCurve<5243, 6553, 6554, 62258, 62258,
+ *                                            62258, 0, 6554, 65535, 65535>;
+ *
+ *  piu_MarginSection fanSection = piu_MarginState_Off;
+ *  uint16_t duty = FanCurve::setX(fanSection, temperature);
+ *
+ *  // Or through the C API, copied from rodata
+ *  piu_MarginedLinear fan = FanCurve::marginedLinear;
+ * @endcode
+ */
+
+
+#ifndef PIU_MARGINED_LINEAR_HPP
+#define PIU_MARGINED_LINEAR_HPP
+
+
+#include <cstdint>
+
+#include "piu_margined_linear.h"
+
+
+namespace piu
+{
+
+template <uint16_t XOff,
+          uint16_t XOn,
+          uint16_t XLinearLow,
+          uint16_t XLinearHigh,
+          uint16_t XStepDown,
+          uint16_t XStepUp,
+          uint16_t YOff,
+          uint16_t YLowFlat,
+          uint16_t YHighFlat,
+          uint16_t YMaxFlat>
+struct MarginedLinearCurve
+{
+    static_assert(XOff <= XOn, "xOff must not be above xOn");
+    static_assert(XOn <= XLinearLow, "xOn must not be above xLinearLow");
+    static_assert(XLinearLow <= XLinearHigh,
+                  "xLinearLow must not be above xLinearHigh");
+    static_assert(XLinearHigh <= XStepDown,
+                  "xLinearHigh must not be above xStepDown");
+    static_assert(XStepDown <= XStepUp, "xStepDown must not be above xStepUp");
+
+    // Same math as calcLinear and calcLinearQ16 in piu_margined_linear.c, a
+    // curve without linear section gets 0 instead of a division by 0
+    static constexpr float linearRate =
+        XLinearHigh == XLinearLow
+            ? 0.0f
+            : ((float)YHighFlat - (float)YLowFlat) /
+                  ((float)XLinearHigh - (float)XLinearLow);
+
+    static constexpr bool linearFalling = YHighFlat < YLowFlat;
+
+    static constexpr uint32_t linearRateQ16 =
+        XLinearHigh == XLinearLow
+            ? 0
+            : (uint32_t)(((uint64_t)(linearFalling ? YLowFlat - YHighFlat
+                                                   : YHighFlat - YLowFlat)
+                              << 16) +
+                         (XLinearHigh - XLinearLow) / 2) /
+                  (XLinearHigh - XLinearLow);
+
+    /**
+     * @brief The curve as a piu_MarginedLinear in the Off state, equal to
+     *      what piu_MarginedLinear_make builds
+     */
+    static constexpr piu_MarginedLinear marginedLinear = {
+        .currentState       = piu_MarginState_Off,
+        .xOff               = XOff,
+        .xOn                = XOn,
+        .xLinearLow         = XLinearLow,
+        .xLinearHigh        = XLinearHigh,
+        .xStepDown          = XStepDown,
+        .xStepUp            = XStepUp,
+        .yOff               = YOff,
+        .yLowFlat           = YLowFlat,
+        .yHighFlat          = YHighFlat,
+        .yMaxFlat           = YMaxFlat,
+#ifdef PIU_MARGINED_LINEAR_FIXED_POINT
+        .linearRate         = 0,
+#else
+        .linearRate         = linearRate,
+#endif
+        .linearRateQ16      = linearRateQ16,
+        .flag_linearFalling = linearFalling,
+        .lastInput          = XOff,
+        .lut                = nullptr,
+        .lutCapacity        = 0,
+        .lutCount           = 0,
+        .lutFirstY          = 0,
+        .flag_lutSteps      = false,
+        .flag_lutReady      = false,
+        .flag_lutDirty      = true,
+    };
+
+    /**
+     * @brief Output of a section for an input, piu_MarginedLinear_getY with
+     *      the constants folded in
+     */
+    static constexpr uint16_t getY(piu_MarginSection section, uint16_t x)
+    {
+        switch (section)
+        {
+        case piu_MarginState_LowFlat: return YLowFlat;
+        case piu_MarginState_Linear: return linearY(x);
+        case piu_MarginState_HighFlat: return YHighFlat;
+        case piu_MarginState_MaxFlat: return YMaxFlat;
+        default: return YOff;
+        }
+    }
+
+    /**
+     * @brief Advance the section with a new input, piu_MarginedLinear_setX
+     *      with the constants folded in
+     * @param section Current section, updated in place
+     * @param x The new input value
+     * @return The new output value
+     */
+    static constexpr uint16_t setX(piu_MarginSection& section, uint16_t x)
+    {
+        if (section > piu_MarginState_MaxFlat)
+        {
+            section = piu_MarginState_Off;
+            return YOff;
+        }
+
+        const uint32_t rising = (uint32_t)(x > XOn) +
+                                (uint32_t)(x > XLinearLow) +
+                                (uint32_t)(x > XLinearHigh) +
+                                (uint32_t)(x > XStepUp);
+        const uint32_t falling = (uint32_t)(x > XOff) +
+                                 (uint32_t)(x > XLinearLow) +
+                                 (uint32_t)(x > XLinearHigh) +
+                                 (uint32_t)(x > XStepDown);
+
+        const uint32_t current = section;
+        const uint32_t lower   = current < falling ? current : falling;
+        section = (piu_MarginSection)(lower > rising ? lower : rising);
+
+        return getY(section, x);
+    }
+
+private:
+    static constexpr uint16_t linearY(uint16_t x)
+    {
+#ifdef PIU_MARGINED_LINEAR_FIXED_POINT
+        const uint64_t product = (uint64_t)linearRateQ16 *
+                                 (uint32_t)(x - XLinearLow);
+        if constexpr (linearFalling)
+        {
+            return (uint16_t)(YLowFlat - (uint32_t)((product + 0xFFFF) >> 16));
+        }
+        return (uint16_t)(YLowFlat + (uint32_t)(product >> 16));
+#else
+        return (uint16_t)((linearRate * (float)(x - XLinearLow)) +
+                          (float)YLowFlat);
+#endif
+    }
+};
+
+}    // namespace piu
+
+
+#endif    // PIU_MARGINED_LINEAR_HPP
@@ -0,0 +1,214 @@
+//
+// Created by YthanZhang on 2026/10/19.
+//
+/*******************************************************************************
+ * Copyright 2021 Ythan(Ethan) Zhang
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************
+ * This software component is licensed by Ythan Zhang under the
+ *                           BSD-2-Clause license.
+ * You may not use this file except in compliance with the license.
+ * You may obtain a copy of the License at: opensource.org/licenses/BSD-2-Clause
+ ******************************************************************************/
+
+
+#include "piu_margined_linear_bank.h"
+
+#include <string.h>
+
+
+piu_MarginedLinearBank* piu_MarginedLinearBank_construct(
+    piu_MarginedLinearBank* bank, uint32_t* storage, size_t count)
+{
+    memset(storage, 0, PIU_MARGINED_LINEAR_BANK_WORDS(count) * 4);
+
+    bank->count      = count;
+    bank->linearRate = storage;
+
+    uint16_t* half    = (uint16_t*)(storage + count);
+    bank->xOff        = half;
+    bank->xOn         = half + count;
+    bank->xLinearLow  = half + count * 2;
+    bank->xLinearHigh = half + count * 3;
+    bank->xStepDown   = half + count * 4;
+    bank->xStepUp     = half + count * 5;
+    bank->yOff        = half + count * 6;
+    bank->yLowFlat    = half + count * 7;
+    bank->yHighFlat   = half + count * 8;
+    bank->yMaxFlat    = half + count * 9;
+
+    bank->state         = (uint8_t*)(half + count * 10);
+    bank->linearFalling = bank->state + count;
+
+    return bank;
+}
+
+
+void piu_MarginedLinearBank_setInstance(
+    piu_MarginedLinearBank* bank,
+    size_t index,
+    const piu_MarginedLinear* marginedLinear)
+{
+#ifdef PIU_MARGINED_LINEAR_FIXED_POINT
+    bank->linearRate[index] = marginedLinear->linearRateQ16;
+#else
+    // calcLinear divides by 0 for an empty linear section, the update loop
+    // evaluates the slope for every instance so it has to stay finite
+    const float rate =
+        marginedLinear->xLinearLow == marginedLinear->xLinearHigh
+            ? 0.0f
+            : marginedLinear->linearRate;
+    memcpy(&bank->linearRate[index], &rate, 4);
+#endif
+
+    bank->xOff[index]        = marginedLinear->xOff;
+    bank->xOn[index]         = marginedLinear->xOn;
+    bank->xLinearLow[index]  = marginedLinear->xLinearLow;
+    bank->xLinearHigh[index] = marginedLinear->xLinearHigh;
+    bank->xStepDown[index]   = marginedLinear->xStepDown;
+    bank->xStepUp[index]     = marginedLinear->xStepUp;
+
+    bank->yOff[index]      = marginedLinear->yOff;
+    bank->yLowFlat[index]  = marginedLinear->yLowFlat;
+    bank->yHighFlat[index] = marginedLinear->yHighFlat;
+    bank->yMaxFlat[index]  = marginedLinear->yMaxFlat;
+
+    // An invalid state goes to Off like piu_MarginedLinear_setX does, so the
+    // update loop does not need to check
+    bank->state[index] =
+        marginedLinear->currentState > piu_MarginState_MaxFlat
+            ? piu_MarginState_Off
+            : (uint8_t)marginedLinear->currentState;
+    bank->linearFalling[index] = marginedLinear->flag_linearFalling;
+}
+
+
+// The ten uint16 parameter arrays are consecutive, stride apart, starting at
+// params. Only function parameters get restrict honored by compilers, with
+// every array a separate pointer there would be too many overlap checks to
+// vectorize the loop.
+static void updateRange(const uint16_t* restrict in,
+                        uint16_t* restrict out,
+                        uint8_t* restrict state,
+                        const uint32_t* restrict linearRate,
+                        const uint8_t* restrict linearFalling,
+                        const uint16_t* restrict params,
+                        size_t stride,
+                        size_t count)
+{
+    const uint16_t* xOff        = params;
+    const uint16_t* xOn         = params + stride;
+    const uint16_t* xLinearLow  = params + stride * 2;
+    const uint16_t* xLinearHigh = params + stride * 3;
+    const uint16_t* xStepDown   = params + stride * 4;
+    const uint16_t* xStepUp     = params + stride * 5;
+    const uint16_t* yOff        = params + stride * 6;
+    const uint16_t* yLowFlat    = params + stride * 7;
+    const uint16_t* yHighFlat   = params + stride * 8;
+    const uint16_t* yMaxFlat    = params + stride * 9;
+
+#ifdef PIU_MARGINED_LINEAR_FIXED_POINT
+    const uint32_t* rate = linearRate;
+#else
+    const float* rate = (const float*)linearRate;
+    (void)linearFalling;
+#endif
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const uint16_t x        = in[i];
+        const uint16_t linearLo = xLinearLow[i];
+        const uint16_t linearHi = xLinearHigh[i];
+        const uint16_t yLow     = yLowFlat[i];
+        const uint16_t yHigh    = yHighFlat[i];
+        const uint16_t yMax     = yMaxFlat[i];
+        const uint8_t current   = state[i];
+
+        // Same transition as piu_MarginedLinear_setX
+        const uint8_t rising  = (uint8_t)((x > xOn[i]) + (x > linearLo) +
+                                         (x > linearHi) + (x > xStepUp[i]));
+        const uint8_t falling = (uint8_t)((x > xOff[i]) + (x > linearLo) +
+                                          (x > linearHi) + (x > xStepDown[i]));
+        const uint8_t lower   = current < falling ? current : falling;
+        const uint8_t next    = lower > rising ? lower : rising;
+        state[i]              = next;
+
+        // Only used in the linear section but evaluated for every instance,
+        // clamped into the section so the result stays in [0, 65535] and the
+        // float to int conversion is defined. min/max vectorize, a select
+        // around the subtraction ends up as a branch around the convert
+        const uint16_t xHigh = x < linearHi ? x : linearHi;
+        const uint16_t xIn   = xHigh > linearLo ? xHigh : linearLo;
+        const uint16_t dx    = (uint16_t)(xIn - linearLo);
+#ifdef PIU_MARGINED_LINEAR_FIXED_POINT
+        // rate * dx in two 32 bit halves, there is no 64 bit vector multiply
+        const uint32_t productHigh = (rate[i] >> 16) * dx;
+        const uint32_t productLow  = (rate[i] & 0xFFFF) * dx;
+        const uint16_t rise =
+            (uint16_t)(yLow + productHigh + (productLow >> 16));
+        const uint16_t fall =
+            (uint16_t)(yLow - productHigh - ((productLow + 0xFFFF) >> 16));
+        const uint16_t down   = (uint16_t)-(linearFalling[i] != 0);
+        const uint16_t linear = (uint16_t)((fall & down) | (rise & ~down));
+#else
+        // In [0, 65535] with dx clamped, int32_t conversion has a vector
+        // instruction
+        const uint16_t linear =
+            (uint16_t)(int32_t)((rate[i] * (float)dx) + (float)yLow);
+#endif
+
+        // Masks instead of selects, otherwise the float math above gets
+        // sunk under a branch and the loop is not vectorized
+        const uint16_t off  = (uint16_t)-(next == piu_MarginState_Off);
+        const uint16_t lowF = (uint16_t)-(next == piu_MarginState_LowFlat);
+        const uint16_t lin  = (uint16_t)-(next == piu_MarginState_Linear);
+        const uint16_t high = (uint16_t)-(next == piu_MarginState_HighFlat);
+        const uint16_t max  = (uint16_t)-(next == piu_MarginState_MaxFlat);
+
+        out[i] = (uint16_t)((yOff[i] & off) | (yLow & lowF) | (linear & lin) |
+                            (yHigh & high) | (yMax & max));
+    }
+}
+
+void piu_MarginedLinearBank_update(piu_MarginedLinearBank* bank,
+                                   const uint16_t* in,
+                                   uint16_t* out,
+                                   size_t begin,
+                                   size_t end)
+{
+    updateRange(in + begin,
+                out + begin,
+                bank->state + begin,
+                bank->linearRate + begin,
+                bank->linearFalling + begin,
+                bank->xOff + begin,
+                bank->count,
+                end - begin);
+}
+
+
+piu_MarginSection piu_MarginedLinearBank_getState(
+    const piu_MarginedLinearBank* bank, size_t index)
+{
+    return (piu_MarginSection)bank->state[index];
+}
@@ -0,0 +1,173 @@
+//
+// Created by YthanZhang on 2026/10/19.
+//
+/*******************************************************************************
+ * Copyright 2021 Ythan(Ethan) Zhang
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************
+ * This software component is licensed by Ythan Zhang under the
+ *                           BSD-2-Clause license.
+ * You may not use this file except in compliance with the license.
+ * You may obtain a copy of the License at: opensource.org/licenses/BSD-2-Clause
+ ******************************************************************************/
+
+
+/*******************************************************************************
+ * @file piu_margined_linear_bank.h
+ *
+ * Many piu_MarginedLinear instances in structure of arrays layout. @n
+ *
+ * Every parameter is its own array indexed by instance, so one call of
+ *  <b>piu_MarginedLinearBank_update</b> runs the same branchless transition
+ *  and output select as piu_MarginedLinear_setX over contiguous uint16
+ *  arrays, which the compiler vectorizes. Instances are independent, a range
+ *  of instances can be updated from different threads at the same time as
+ *  long as the ranges do not overlap. @n
+ *
+ * The bank does not allocate, the caller provides the storage sized by
+ *  <b>PIU_MARGINED_LINEAR_BANK_WORDS</b>.
+ *
+ * @example 100k fans, each thread updates its own quarter
+ * @code
+ *  #define FAN_COUNT 100000
+ *  static uint32_t fanStorage[PIU_MARGINED_LINEAR_BANK_WORDS(FAN_COUNT)];
+ *  static uint16_t temperature[FAN_COUNT];
+ *  static uint16_t duty[FAN_COUNT];
+ *
+ *  piu_MarginedLinearBank fans;
+ *  piu_MarginedLinearBank_construct(&fans, fanStorage, FAN_COUNT);
+ *  for (size_t i = 0; i < FAN_COUNT; ++i)
+ *  {
+ *      piu_MarginedLinearBank_setInstance(&fans, i, &fanCurve);
+ *  }
+ *
+ *  // Thread n of 4
+ *  piu_MarginedLinearBank_update(&fans, temperature, duty,
+ *                                FAN_COUNT * n / 4, FAN_COUNT * (n + 1) / 4);
+ * @endcode
+ */
+
+
+#ifndef PIU_MARGINED_LINEAR_BANK_H
+#define PIU_MARGINED_LINEAR_BANK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "piu_margined_linear.h"
+
+
+/**
+ * @brief Number of uint32_t words of storage a bank of COUNT instances needs,
+ *      26 bytes per instance
+ */
+#define PIU_MARGINED_LINEAR_BANK_WORDS(COUNT) (((COUNT) * 26 + 3) / 4)
+
+
+/**
+ * @warning You must NEVER directly modify any of the internal data directly,
+ *      always use functions that came with the struct to operate with it.
+ */
+typedef struct struct_piu_MarginedLinearBank
+{
+    size_t count;
+
+    // Float slope, or Q16.16 magnitude with PIU_MARGINED_LINEAR_FIXED_POINT
+    uint32_t* linearRate;
+
+    uint16_t* xOff;
+    uint16_t* xOn;
+    uint16_t* xLinearLow;
+    uint16_t* xLinearHigh;
+    uint16_t* xStepDown;
+    uint16_t* xStepUp;
+
+    uint16_t* yOff;
+    uint16_t* yLowFlat;
+    uint16_t* yHighFlat;
+    uint16_t* yMaxFlat;
+
+    uint8_t* state;    // piu_MarginSection of each instance
+    uint8_t* linearFalling;
+} piu_MarginedLinearBank;
+
+
+/**
+ * @brief Construct a bank, every instance starts with all parameters 0
+ * @param bank Pointer to an empty piu_MarginedLinearBank struct
+ * @param storage PIU_MARGINED_LINEAR_BANK_WORDS(count) words of storage
+ * @param count Number of instances
+ * @return Pointer to the struct passed in
+ */
+piu_MarginedLinearBank* piu_MarginedLinearBank_construct(
+    piu_MarginedLinearBank* bank, uint32_t* storage, size_t count);
+
+/**
+ * @brief Copy the parameters and current state of a piu_MarginedLinear into
+ *      one instance of the bank
+ * @param bank Pointer to a piu_MarginedLinearBank struct
+ * @param index Instance index
+ * @param marginedLinear The instance to copy
+ */
+void piu_MarginedLinearBank_setInstance(
+    piu_MarginedLinearBank* bank,
+    size_t index,
+    const piu_MarginedLinear* marginedLinear);
+
+/**
+ * @brief Update instances [begin, end) with new input values
+ * @note Output of each instance is the same as piu_MarginedLinear_setX of the
+ *      struct it was copied from. @p in and @p out must not overlap
+ * @param bank Pointer to a piu_MarginedLinearBank struct
+ * @param in Input value of every instance, indexed from 0
+ * @param out Output value of every instance, indexed from 0
+ * @param begin First instance to update
+ * @param end One past the last instance to update
+ */
+void piu_MarginedLinearBank_update(piu_MarginedLinearBank* bank,
+                                   const uint16_t* in,
+                                   uint16_t* out,
+                                   size_t begin,
+                                   size_t end);
+
+/**
+ * @brief Get the current section of an instance
+ * @param bank Pointer to a piu_MarginedLinearBank struct
+ * @param index Instance index
+ * @return Current section
+ */
+piu_MarginSection piu_MarginedLinearBank_getState(
+    const piu_MarginedLinearBank* bank, size_t index);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif    // PIU_MARGINED_LINEAR_BANK_H
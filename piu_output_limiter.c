@@ -0,0 +1,120 @@
+//
+// Created by YthanZhang on 2026/10/19.
+//
+/*******************************************************************************
+ * Copyright 2021 Ythan(Ethan) Zhang
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************
+ * This software component is licensed by Ythan Zhang under the
+ *                           BSD-2-Clause license.
+ * You may not use this file except in compliance with the license.
+ * You may obtain a copy of the License at: opensource.org/licenses/BSD-2-Clause
+ ******************************************************************************/
+
+
+#include "piu_output_limiter.h"
+
+
+piu_OutputLimiter* piu_OutputLimiter_construct(piu_OutputLimiter* limiter,
+                                               uint16_t slewStep,
+                                               uint16_t deadband,
+                                               uint16_t initial)
+{
+    limiter->slewStep     = slewStep;
+    limiter->deadband     = deadband;
+    limiter->target       = initial;
+    limiter->output       = initial;
+    limiter->flag_changed = false;
+
+    return limiter;
+}
+
+
+bool piu_OutputLimiter_setTarget(piu_OutputLimiter* limiter, uint16_t target)
+{
+    const uint16_t delta = target > limiter->target
+                               ? target - limiter->target
+                               : limiter->target - target;
+    if (delta == 0 ||
+        (delta <= limiter->deadband && target != 0 && target != UINT16_MAX))
+    {
+        return false;
+    }
+
+    limiter->target = target;
+    return true;
+}
+
+uint16_t piu_OutputLimiter_tick(piu_OutputLimiter* limiter)
+{
+    const uint16_t target = limiter->target;
+    const uint16_t output = limiter->output;
+    if (output == target)
+    {
+        return output;
+    }
+
+    const uint16_t delta = target > output ? target - output : output - target;
+    if (limiter->slewStep == 0 || delta <= limiter->slewStep)
+    {
+        limiter->output = target;
+    }
+    else if (target > output)
+    {
+        limiter->output = output + limiter->slewStep;
+    }
+    else
+    {
+        limiter->output = output - limiter->slewStep;
+    }
+
+    limiter->flag_changed = true;
+    return limiter->output;
+}
+
+uint16_t piu_OutputLimiter_update(piu_OutputLimiter* limiter, uint16_t target)
+{
+    piu_OutputLimiter_setTarget(limiter, target);
+    return piu_OutputLimiter_tick(limiter);
+}
+
+
+uint16_t piu_OutputLimiter_getOutput(const piu_OutputLimiter* limiter)
+{
+    return limiter->output;
+}
+
+bool piu_OutputLimiter_getChanged(piu_OutputLimiter* limiter)
+{
+    bool flag             = limiter->flag_changed;
+    limiter->flag_changed = false;
+    return flag;
+}
+
+void piu_OutputLimiter_setLimits(piu_OutputLimiter* limiter,
+                                 uint16_t slewStep,
+                                 uint16_t deadband)
+{
+    limiter->slewStep = slewStep;
+    limiter->deadband = deadband;
+}
@@ -0,0 +1,175 @@
+//
+// Created by YthanZhang on 2026/10/19.
+//
+/*******************************************************************************
+ * Copyright 2021 Ythan(Ethan) Zhang
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************
+ * This software component is licensed by Ythan Zhang under the
+ *                           BSD-2-Clause license.
+ * You may not use this file except in compliance with the license.
+ * You may obtain a copy of the License at: opensource.org/licenses/BSD-2-Clause
+ ******************************************************************************/
+
+
+/*******************************************************************************
+ * @file piu_output_limiter.h
+ *
+ * Slew rate limit and deadband stage for a uint16 output, meant to sit
+ *  between piu_MarginedLinear and a PWM register or a downstream drive. @n
+ *
+ * <b>piu_OutputLimiter_setTarget</b> takes the raw output and ignores changes
+ *  within the deadband of the current target, so sensor noise in the linear
+ *  section does not move the output. <b>piu_OutputLimiter_tick</b> moves the
+ *  output toward the target by at most the slew step per call. @n
+ *
+ * <b>piu_OutputLimiter_getChanged</b> reports whether the output moved since
+ *  the last query, writes that would do nothing can be skipped. @n
+ *
+ * @example Fan PWM updated every 10ms, ramp at most 500 per tick, ignore
+ *  changes of 64 or less
+ * @code
+ *  piu_OutputLimiter fanOutput = PIU_OUTPUT_LIMITER_MAKE(500, 64, 0);
+ *
+ *  void TIMER_10MS_IT_HANDLE(void)
+ *  {
+ *      piu_OutputLimiter_update(&fanOutput,
+ *                               piu_MarginedLinear_setX(&fanCurve, adc));
+ *      if (piu_OutputLimiter_getChanged(&fanOutput))
+ *      {
+ *          TIM3->CCR1 = piu_OutputLimiter_getOutput(&fanOutput);
+ *      }
+ *  }
+ * @endcode
+ */
+
+
+#ifndef PIU_OUTPUT_LIMITER_H
+#define PIU_OUTPUT_LIMITER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/**
+ * @warning All data contained in this struct should be considered private and
+ *      should not be accessed or modified directly.
+ */
+typedef struct piu_struct_OutputLimiter
+{
+    uint16_t slewStep;    // Max output change per tick, 0 for no limit
+    uint16_t deadband;    // Target changes up to this are ignored
+
+    uint16_t target;
+    uint16_t output;
+
+    bool flag_changed;
+} piu_OutputLimiter;
+
+
+/**
+ * @brief Use this macro to initialize a piu_OutputLimiter struct
+ * @param SLEW_STEP Max output change per tick, 0 for no limit
+ * @param DEADBAND Target changes up to this value are ignored, 0 to disable
+ * @param INITIAL The initial output value
+ */
+#define PIU_OUTPUT_LIMITER_MAKE(SLEW_STEP, DEADBAND, INITIAL)                  \
+    {                                                                          \
+        (SLEW_STEP), (DEADBAND), (INITIAL), (INITIAL), false                   \
+    }
+
+
+/**
+ * @brief Initialize a piu_OutputLimiter struct
+ * @param limiter Pointer to an uninitialized piu_OutputLimiter struct
+ * @param slewStep Max output change per tick, 0 for no limit
+ * @param deadband Target changes up to this value are ignored, 0 to disable
+ * @param initial The initial output value
+ * @return Pointer to the same piu_OutputLimiter struct passed in
+ */
+piu_OutputLimiter* piu_OutputLimiter_construct(piu_OutputLimiter* limiter,
+                                               uint16_t slewStep,
+                                               uint16_t deadband,
+                                               uint16_t initial);
+
+/**
+ * @brief Set a new target output
+ * @note Ignored when within the deadband of the current target, except when
+ *      it is 0 or UINT16_MAX so the output can still reach full off and full
+ *      on
+ * @param limiter Pointer to a piu_OutputLimiter struct
+ * @param target The raw output value, e.g. from piu_MarginedLinear_setX
+ * @return @p true if the target was accepted
+ */
+bool piu_OutputLimiter_setTarget(piu_OutputLimiter* limiter, uint16_t target);
+
+/**
+ * @brief Move the output toward the target, call at a constant interval
+ * @param limiter Pointer to a piu_OutputLimiter struct
+ * @return The new output value
+ */
+uint16_t piu_OutputLimiter_tick(piu_OutputLimiter* limiter);
+
+/**
+ * @brief piu_OutputLimiter_setTarget followed by piu_OutputLimiter_tick
+ * @param limiter Pointer to a piu_OutputLimiter struct
+ * @param target The raw output value
+ * @return The new output value
+ */
+uint16_t piu_OutputLimiter_update(piu_OutputLimiter* limiter, uint16_t target);
+
+/**
+ * @brief Get the current output value
+ * @param limiter Pointer to a piu_OutputLimiter struct
+ * @return The current output value
+ */
+uint16_t piu_OutputLimiter_getOutput(const piu_OutputLimiter* limiter);
+
+/**
+ * @brief Check if the output changed, the flag is cleared after read
+ * @param limiter Pointer to a piu_OutputLimiter struct
+ * @return @p true if the output changed since the last call
+ */
+bool piu_OutputLimiter_getChanged(piu_OutputLimiter* limiter);
+
+/**
+ * @brief Change the slew step and deadband, the output is kept
+ * @param limiter Pointer to a piu_OutputLimiter struct
+ * @param slewStep Max output change per tick, 0 for no limit
+ * @param deadband Target changes up to this value are ignored, 0 to disable
+ */
+void piu_OutputLimiter_setLimits(piu_OutputLimiter* limiter,
+                                 uint16_t slewStep,
+                                 uint16_t deadband);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif    // PIU_OUTPUT_LIMITER_H
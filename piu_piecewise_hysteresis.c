@@ -0,0 +1,200 @@
+//
+// Created by YthanZhang on 2026/10/19.
+//
+/*******************************************************************************
+ * Copyright 2021 Ythan(Ethan) Zhang
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************
+ * This software component is licensed by Ythan Zhang under the
+ *                           BSD-2-Clause license.
+ * You may not use this file except in compliance with the license.
+ * You may obtain a copy of the License at: opensource.org/licenses/BSD-2-Clause
+ ******************************************************************************/
+
+
+#include "piu_piecewise_hysteresis.h"
+
+
+// Number of breakpoints whose xRise is below x, branchless lower bound
+static uint16_t countRiseBelow(const piu_PiecewiseSegment* table,
+                               uint16_t count,
+                               uint16_t x)
+{
+    const piu_PiecewiseSegment* base = table;
+    uint16_t len                     = count;
+    while (len > 1)
+    {
+        const uint16_t half = len / 2;
+        base += (base[half].xRise < x) ? half : 0;
+        len -= half;
+    }
+    return (uint16_t)((base - table) + (base->xRise < x));
+}
+
+// Number of breakpoints whose xFall is below x, branchless lower bound
+static uint16_t countFallBelow(const piu_PiecewiseSegment* table,
+                               uint16_t count,
+                               uint16_t x)
+{
+    const piu_PiecewiseSegment* base = table;
+    uint16_t len                     = count;
+    while (len > 1)
+    {
+        const uint16_t half = len / 2;
+        base += (base[half].xFall < x) ? half : 0;
+        len -= half;
+    }
+    return (uint16_t)((base - table) + (base->xFall < x));
+}
+
+static uint16_t findSegment(const piu_PiecewiseHysteresis* curve, uint16_t x)
+{
+    const piu_PiecewiseSegment* table = curve->table;
+    const uint16_t count              = curve->count;
+    const uint16_t segment            = curve->segment;
+
+    if (segment < count && x > table[segment].xRise)
+    {
+        // Rising, one step is the common case
+        if (segment + 1 == count || x <= table[segment + 1].xRise)
+        {
+            return segment + 1;
+        }
+        return countRiseBelow(table, count, x);
+    }
+    if (segment > 0 && x <= table[segment - 1].xFall)
+    {
+        if (segment == 1 || x > table[segment - 2].xFall)
+        {
+            return segment - 1;
+        }
+        return countFallBelow(table, count, x);
+    }
+    return segment;
+}
+
+
+piu_PiecewiseHysteresis* piu_PiecewiseHysteresis_construct(
+    piu_PiecewiseHysteresis* curve,
+    const piu_PiecewisePoint* points,
+    piu_PiecewiseSegment* table,
+    uint16_t count)
+{
+    curve->points    = points;
+    curve->table     = table;
+    curve->count     = count;
+    curve->lastInput = 0;
+
+    piu_PiecewiseHysteresis_updatePoints(curve);
+
+    return curve;
+}
+
+
+uint16_t piu_PiecewiseHysteresis_setX(piu_PiecewiseHysteresis* curve,
+                                      uint16_t inputVal)
+{
+    curve->lastInput = inputVal;
+    curve->segment   = findSegment(curve, inputVal);
+
+    return piu_PiecewiseHysteresis_getY(curve);
+}
+
+uint16_t piu_PiecewiseHysteresis_getY(const piu_PiecewiseHysteresis* curve)
+{
+    if (curve->segment == 0)
+    {
+        return curve->count == 0 ? 0 : curve->table[0].y;
+    }
+
+    // Inside the hysteresis band below the segment the output holds at the
+    // breakpoint value
+    const piu_PiecewiseSegment* start = &curve->table[curve->segment - 1];
+    const uint32_t dx =
+        curve->lastInput > start->xRise ? curve->lastInput - start->xRise : 0;
+    const uint32_t dy =
+        (uint32_t)(((uint64_t)start->slopeQ16 * dx + 0x8000) >> 16);
+
+    return start->flag_falling ? (uint16_t)(start->y - dy)
+                               : (uint16_t)(start->y + dy);
+}
+
+uint16_t piu_PiecewiseHysteresis_getSegment(
+    const piu_PiecewiseHysteresis* curve)
+{
+    return curve->segment;
+}
+
+
+void piu_PiecewiseHysteresis_updatePoints(piu_PiecewiseHysteresis* curve)
+{
+    const piu_PiecewisePoint* points = curve->points;
+    piu_PiecewiseSegment* table      = curve->table;
+
+    // Same policy as piu_MarginedLinear, raise values that are out of order
+    for (uint16_t i = 0; i < curve->count; ++i)
+    {
+        table[i].xRise = points[i].xRise;
+        table[i].xFall = points[i].xFall;
+        table[i].y     = points[i].y;
+        if (i > 0 && table[i].xRise < table[i - 1].xRise)
+        {
+            table[i].xRise = table[i - 1].xRise;
+        }
+        if (table[i].xFall > table[i].xRise)
+        {
+            table[i].xFall = table[i].xRise;
+        }
+        if (i > 0 && table[i].xFall < table[i - 1].xFall)
+        {
+            table[i].xFall = table[i - 1].xFall;
+        }
+    }
+
+    // Segment above the last breakpoint is flat
+    for (uint16_t i = 0; i < curve->count; ++i)
+    {
+        table[i].slopeQ16     = 0;
+        table[i].flag_falling = false;
+        if (i + 1 == curve->count)
+        {
+            break;
+        }
+
+        const uint32_t dx = table[i + 1].xRise - table[i].xRise;
+        if (dx == 0)
+        {
+            continue;
+        }
+
+        const bool falling = table[i + 1].y < table[i].y;
+        const uint32_t dy  = falling ? table[i].y - table[i + 1].y
+                                     : table[i + 1].y - table[i].y;
+
+        table[i].slopeQ16 = (uint32_t)((((uint64_t)dy << 16) + dx / 2) / dx);
+        table[i].flag_falling = falling;
+    }
+
+    curve->segment = 0;
+    piu_PiecewiseHysteresis_setX(curve, curve->lastInput);
+}
@@ -0,0 +1,183 @@
+//
+// Created by YthanZhang on 2026/10/19.
+//
+/*******************************************************************************
+ * Copyright 2021 Ythan(Ethan) Zhang
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************
+ * This software component is licensed by Ythan Zhang under the
+ *                           BSD-2-Clause license.
+ * You may not use this file except in compliance with the license.
+ * You may obtain a copy of the License at: opensource.org/licenses/BSD-2-Clause
+ ******************************************************************************/
+
+
+#ifndef PIU_PIECEWISE_HYSTERESIS_H
+#define PIU_PIECEWISE_HYSTERESIS_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+
+/***************************************************************************//**
+ * @file piu_piecewise_hysteresis.h
+ * Piecewise linear curve with any number of segments and a hysteresis band at
+ * every breakpoint, the N segment generalization of piu_MarginedLinear. @n
+ *
+ * N breakpoints split the input range into N + 1 segments. Segment 0 is below
+ * the first breakpoint and outputs its y, segment N is above the last one and
+ * outputs its y, segment i in between is linear from breakpoint i - 1 to
+ * breakpoint i. The input moves to the segment above a breakpoint when it goes
+ * above xRise and back below it only when it goes to or below xFall, inside
+ * the band the output holds at the breakpoint y. @n
+ *
+ * The current segment is cached, an input inside it or one of its neighbours
+ * is resolved with at most two compares, larger jumps use a branchless binary
+ * search. Slopes are precomputed in Q16.16, evaluation is one multiply no
+ * matter how many segments there are. @n
+ *
+ * The breakpoints are only read, they can be const and live in flash. The
+ * ordered copy and the slopes go to a separate segment table that the caller
+ * provides, one entry per breakpoint.
+ *
+ * @example
+ * @code
+ * static const piu_PiecewisePoint fanPoints[] = {
+ *     {.xRise = 1000, .xFall = 900, .y = 0},
+ *     {.xRise = 2000, .xFall = 1900, .y = 20000},
+ *     {.xRise = 3000, .xFall = 2900, .y = 40000},
+ *     {.xRise = 4000, .xFall = 3900, .y = 65535},
+ * };
+ * static piu_PiecewiseSegment fanTable[4];
+ * piu_PiecewiseHysteresis fan;
+ * piu_PiecewiseHysteresis_construct(&fan, fanPoints, fanTable, 4);
+ *
+ * uint16_t duty = piu_PiecewiseHysteresis_setX(&fan, temperature);
+ * @endcode
+ ******************************************************************************/
+
+
+/**
+ * @brief One breakpoint of a piu_PiecewiseHysteresis curve
+ * @note xRise must be ascending across the array and xFall <= xRise,
+ *      construct fixes violations the same way piu_MarginedLinear does, in
+ *      the segment table, the breakpoints themselves are not modified
+ */
+typedef struct struct_piu_PiecewisePoint
+{
+    uint16_t xRise;    // Enter the segment above when input goes above this
+    uint16_t xFall;    // Leave it when input goes to or below this
+    uint16_t y;
+} piu_PiecewisePoint;
+
+/**
+ * @brief Segment table entry, filled by construct and updatePoints from the
+ *      breakpoint with the same index
+ * @warning You must NEVER directly modify any of the internal data directly,
+ *      always use functions that came with the struct to operate with it.
+ */
+typedef struct struct_piu_PiecewiseSegment
+{
+    uint16_t xRise;    // Breakpoint after the ordering fix
+    uint16_t xFall;
+    uint16_t y;
+    bool flag_falling;    // Slope of the segment above this breakpoint
+    uint32_t slopeQ16;
+} piu_PiecewiseSegment;
+
+
+/**
+ * @warning You must NEVER directly modify any of the internal data directly,
+ *      always use functions that came with the struct to operate with it.
+ */
+typedef struct struct_piu_PiecewiseHysteresis
+{
+    const piu_PiecewisePoint* points;
+    piu_PiecewiseSegment* table;
+    uint16_t count;
+
+    uint16_t segment;    // 0 to count
+    uint16_t lastInput;
+} piu_PiecewiseHysteresis;
+
+
+/**
+ * @brief Construct a piecewise hysteresis curve
+ * @param curve Pointer to an empty piu_PiecewiseHysteresis struct
+ * @param points Breakpoint array, owned by the caller and must outlive @p curve
+ * @param table Segment table with @p count entries, owned by the caller and
+ *      must outlive @p curve
+ * @param count Number of breakpoints
+ * @return Pointer to the struct passed in
+ */
+piu_PiecewiseHysteresis* piu_PiecewiseHysteresis_construct(
+    piu_PiecewiseHysteresis* curve,
+    const piu_PiecewisePoint* points,
+    piu_PiecewiseSegment* table,
+    uint16_t count);
+
+/**
+ * @brief Update the curve with new input value
+ * @param curve Pointer to a piu_PiecewiseHysteresis struct
+ * @param inputVal The new input value
+ * @return The new output value
+ */
+uint16_t piu_PiecewiseHysteresis_setX(piu_PiecewiseHysteresis* curve,
+                                      uint16_t inputVal);
+
+/**
+ * @brief Get the latest output value
+ * @param curve Pointer to a piu_PiecewiseHysteresis struct
+ * @return The latest output value, 0 for a curve without breakpoints
+ */
+uint16_t piu_PiecewiseHysteresis_getY(const piu_PiecewiseHysteresis* curve);
+
+/**
+ * @brief Get the current segment
+ * @param curve Pointer to a piu_PiecewiseHysteresis struct
+ * @return Segment index, 0 below the first breakpoint, count above the last
+ */
+uint16_t piu_PiecewiseHysteresis_getSegment(
+    const piu_PiecewiseHysteresis* curve);
+
+/**
+ * @brief Apply changes made to the breakpoint array
+ * @note Rebuilds the segment table, ordering fix and slopes, then reevaluates
+ *      the last input from segment 0, like piu_MarginedLinear_updateInput
+ * @param curve Pointer to a piu_PiecewiseHysteresis struct
+ */
+void piu_PiecewiseHysteresis_updatePoints(piu_PiecewiseHysteresis* curve);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif    // PIU_PIECEWISE_HYSTERESIS_H
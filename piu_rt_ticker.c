@@ -0,0 +1,330 @@
+//
+// Created by YthanZhang on 2026/10/19.
+//
+/*******************************************************************************
+ * Copyright 2021 Ythan(Ethan) Zhang
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************
+ * This software component is licensed by Ythan Zhang under the
+ *                           BSD-2-Clause license.
+ * You may not use this file except in compliance with the license.
+ * You may obtain a copy of the License at: opensource.org/licenses/BSD-2-Clause
+ ******************************************************************************/
+
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "piu_rt_ticker.h"
+
+#include <errno.h>
+#include <sched.h>
+#include <time.h>
+
+#include "piu_atomic_vtimer.h"
+#include "piu_button.h"
+#include "piu_vtimer.h"
+
+
+#define NS_PER_S 1000000000LL
+
+
+static int64_t timespecToNs(const struct timespec* ts)
+{
+    return (int64_t)ts->tv_sec * NS_PER_S + ts->tv_nsec;
+}
+
+static struct timespec nsToTimespec(int64_t ns)
+{
+    struct timespec ts;
+    ts.tv_sec  = (time_t)(ns / NS_PER_S);
+    ts.tv_nsec = (long)(ns % NS_PER_S);
+    return ts;
+}
+
+
+static void recordLatency(piu_RTTicker* ticker, int64_t latencyNs)
+{
+    const uint32_t latency = latencyNs < 0            ? 0
+                             : latencyNs > UINT32_MAX ? UINT32_MAX
+                                                      : (uint32_t)latencyNs;
+
+    uint32_t bucket = latency / ticker->bucketNs;
+    if (bucket >= PIU_RT_TICKER_HISTOGRAM_SIZE)
+    {
+        bucket = PIU_RT_TICKER_HISTOGRAM_SIZE - 1;
+    }
+
+    // Only the ticker thread writes, readers may see a slightly torn set of
+    // statistics but never a torn value
+    atomic_fetch_add_explicit(&ticker->histogram[bucket],
+                              1,
+                              memory_order_relaxed);
+    atomic_fetch_add_explicit(&ticker->latencySumNs,
+                              latency,
+                              memory_order_relaxed);
+    if (latency <
+        atomic_load_explicit(&ticker->latencyMinNs, memory_order_relaxed))
+    {
+        atomic_store_explicit(&ticker->latencyMinNs,
+                              latency,
+                              memory_order_relaxed);
+    }
+    if (latency >
+        atomic_load_explicit(&ticker->latencyMaxNs, memory_order_relaxed))
+    {
+        atomic_store_explicit(&ticker->latencyMaxNs,
+                              latency,
+                              memory_order_relaxed);
+    }
+}
+
+static void* tickerThread(void* arg)
+{
+    piu_RTTicker* ticker = (piu_RTTicker*)arg;
+
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    int64_t deadline = timespecToNs(&ts) + ticker->periodNs;
+
+    while (atomic_load_explicit(&ticker->flag_running, memory_order_acquire))
+    {
+        ts = nsToTimespec(deadline);
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) ==
+               EINTR)
+            ;
+
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        const int64_t latency = timespecToNs(&ts) - deadline;
+
+        // Batch advance over whole periods that were slept through
+        const uint64_t missed = latency > 0
+                                    ? (uint64_t)latency / ticker->periodNs
+                                    : 0;
+
+        for (uint64_t t = 0; t <= missed; ++t)
+        {
+            for (size_t i = 0; i < ticker->entryCount; ++i)
+            {
+                ticker->entries[i].tickFunc(ticker->entries[i].object);
+            }
+        }
+        deadline += (int64_t)(missed + 1) * ticker->periodNs;
+
+        recordLatency(ticker, latency);
+        atomic_fetch_add_explicit(&ticker->wakeups, 1, memory_order_relaxed);
+        atomic_fetch_add_explicit(&ticker->ticks,
+                                  missed + 1,
+                                  memory_order_relaxed);
+        atomic_fetch_add_explicit(&ticker->missedTicks,
+                                  missed,
+                                  memory_order_relaxed);
+    }
+
+    return NULL;
+}
+
+
+piu_RTTicker* piu_RTTicker_construct(piu_RTTicker* ticker,
+                                     uint32_t periodNs,
+                                     const piu_RTTickEntry* entries,
+                                     size_t entryCount)
+{
+    ticker->entries    = entries;
+    ticker->entryCount = entryCount;
+
+    ticker->periodNs = periodNs == 0 ? 1 : periodNs;
+    ticker->bucketNs = PIU_RT_TICKER_BUCKET_NS;
+
+    ticker->flag_started  = false;
+    ticker->flag_realTime = false;
+    atomic_init(&ticker->flag_running, false);
+
+    atomic_init(&ticker->wakeups, 0);
+    atomic_init(&ticker->ticks, 0);
+    atomic_init(&ticker->missedTicks, 0);
+    atomic_init(&ticker->latencySumNs, 0);
+    atomic_init(&ticker->latencyMinNs, UINT32_MAX);
+    atomic_init(&ticker->latencyMaxNs, 0);
+    for (size_t i = 0; i < PIU_RT_TICKER_HISTOGRAM_SIZE; ++i)
+    {
+        atomic_init(&ticker->histogram[i], 0);
+    }
+
+    return ticker;
+}
+
+void piu_RTTicker_setBucketWidth(piu_RTTicker* ticker, uint32_t bucketNs)
+{
+    if (!ticker->flag_started && bucketNs != 0)
+    {
+        ticker->bucketNs = bucketNs;
+    }
+}
+
+
+int piu_RTTicker_start(piu_RTTicker* ticker, int priority)
+{
+    if (ticker->flag_started)
+    {
+        return EBUSY;
+    }
+
+    atomic_store_explicit(&ticker->flag_running, true, memory_order_release);
+
+    int err = EPERM;
+    if (priority > 0)
+    {
+        pthread_attr_t attr;
+        struct sched_param param;
+        param.sched_priority = priority;
+
+        pthread_attr_init(&attr);
+        pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+        pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+        pthread_attr_setschedparam(&attr, &param);
+
+        err = pthread_create(&ticker->thread, &attr, tickerThread, ticker);
+        pthread_attr_destroy(&attr);
+
+        ticker->flag_realTime = (err == 0);
+    }
+
+    // Fall back to the default policy if SCHED_FIFO is not permitted
+    if (err == EPERM)
+    {
+        err = pthread_create(&ticker->thread, NULL, tickerThread, ticker);
+    }
+
+    if (err != 0)
+    {
+        atomic_store_explicit(&ticker->flag_running,
+                              false,
+                              memory_order_release);
+        return err;
+    }
+
+    ticker->flag_started = true;
+    return 0;
+}
+
+void piu_RTTicker_stop(piu_RTTicker* ticker)
+{
+    if (!ticker->flag_started)
+    {
+        return;
+    }
+
+    atomic_store_explicit(&ticker->flag_running, false, memory_order_release);
+    pthread_join(ticker->thread, NULL);
+
+    ticker->flag_started  = false;
+    ticker->flag_realTime = false;
+}
+
+
+bool piu_RTTicker_isRealTime(const piu_RTTicker* ticker)
+{
+    return ticker->flag_realTime;
+}
+
+
+void piu_RTTicker_getStats(const piu_RTTicker* ticker,
+                           piu_RTTickerStats* stats)
+{
+    piu_RTTicker* t = (piu_RTTicker*)ticker;
+
+    stats->wakeups = atomic_load_explicit(&t->wakeups, memory_order_relaxed);
+    stats->ticks   = atomic_load_explicit(&t->ticks, memory_order_relaxed);
+    stats->missedTicks =
+        atomic_load_explicit(&t->missedTicks, memory_order_relaxed);
+
+    if (stats->wakeups == 0)
+    {
+        stats->minLatencyNs = 0;
+        stats->avgLatencyNs = 0;
+        stats->p99LatencyNs = 0;
+        stats->maxLatencyNs = 0;
+        return;
+    }
+
+    stats->minLatencyNs =
+        atomic_load_explicit(&t->latencyMinNs, memory_order_relaxed);
+    stats->maxLatencyNs =
+        atomic_load_explicit(&t->latencyMaxNs, memory_order_relaxed);
+    stats->avgLatencyNs = (uint32_t)(atomic_load_explicit(&t->latencySumNs,
+                                                          memory_order_relaxed) /
+                                     stats->wakeups);
+
+    uint64_t total = 0;
+    for (size_t i = 0; i < PIU_RT_TICKER_HISTOGRAM_SIZE; ++i)
+    {
+        total += atomic_load_explicit(&t->histogram[i], memory_order_relaxed);
+    }
+
+    // p99 is the upper edge of the bucket holding the 99th percentile, capped
+    // by the maximum latency actually seen
+    const uint64_t target = total - total / 100;
+    uint64_t count        = 0;
+    size_t bucket         = 0;
+    for (; bucket < PIU_RT_TICKER_HISTOGRAM_SIZE - 1; ++bucket)
+    {
+        count +=
+            atomic_load_explicit(&t->histogram[bucket], memory_order_relaxed);
+        if (count >= target)
+        {
+            break;
+        }
+    }
+
+    const uint64_t edge = (uint64_t)(bucket + 1) * ticker->bucketNs;
+    stats->p99LatencyNs = (bucket == PIU_RT_TICKER_HISTOGRAM_SIZE - 1 ||
+                           edge > stats->maxLatencyNs)
+                              ? stats->maxLatencyNs
+                              : (uint32_t)edge;
+}
+
+void piu_RTTicker_resetStats(piu_RTTicker* ticker)
+{
+    atomic_store_explicit(&ticker->wakeups, 0, memory_order_relaxed);
+    atomic_store_explicit(&ticker->ticks, 0, memory_order_relaxed);
+    atomic_store_explicit(&ticker->missedTicks, 0, memory_order_relaxed);
+    atomic_store_explicit(&ticker->latencySumNs, 0, memory_order_relaxed);
+    atomic_store_explicit(&ticker->latencyMinNs,
+                          UINT32_MAX,
+                          memory_order_relaxed);
+    atomic_store_explicit(&ticker->latencyMaxNs, 0, memory_order_relaxed);
+    for (size_t i = 0; i < PIU_RT_TICKER_HISTOGRAM_SIZE; ++i)
+    {
+        atomic_store_explicit(&ticker->histogram[i], 0, memory_order_relaxed);
+    }
+}
+
+
+void piu_RTTicker_tickVTimer(void* vTimer) { piu_VTimer_tick(vTimer); }
+
+void piu_RTTicker_tickAtomicVTimer(void* vTimer)
+{
+    piu_AtomicVTimer_tick(vTimer);
+}
+
+void piu_RTTicker_tickButton(void* button) { piu_Button_tick(button); }
@@ -0,0 +1,241 @@
+//
+// Created by YthanZhang on 2026/10/19.
+//
+/*******************************************************************************
+ * Copyright 2021 Ythan(Ethan) Zhang
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************
+ * This software component is licensed by Ythan Zhang under the
+ *                           BSD-2-Clause license.
+ * You may not use this file except in compliance with the license.
+ * You may obtain a copy of the License at: opensource.org/licenses/BSD-2-Clause
+ ******************************************************************************/
+
+
+/*******************************************************************************
+ * @file piu_rt_ticker.h
+ *
+ * Linux backend that calls the tick function of registered objects
+ * (<b>piu_VTimer</b>, <b>piu_AtomicVTimer</b>, <b>piu_Button</b> or any
+ * custom function) at a fixed period from a dedicated thread. @n
+ *
+ * The thread sleeps with <b>clock_nanosleep(CLOCK_MONOTONIC,
+ *  TIMER_ABSTIME)</b> on absolute deadlines, so the period does not drift the
+ *  way a <b>usleep</b> loop does. If a wake up is late by one or more whole
+ *  periods, the missed ticks are delivered in a batch on that wake up, so the
+ *  tick count always follows the wall clock. @n
+ *
+ * The wake up latency (actual wake up time - deadline) of every wake up is
+ *  recorded into a histogram, see <b>piu_RTTicker_getStats</b>. @n
+ *
+ * @note The thread requests <b>SCHED_FIFO</b> when started with a non zero
+ *  priority, if the process is not allowed to (no CAP_SYS_NICE or RLIMIT_RTPRIO)
+ *  the thread falls back to the default policy, see
+ *  <b>piu_RTTicker_isRealTime</b>. Locking memory with <b>mlockall</b> is left
+ *  to the application.
+ * @warning The tick functions are called from the ticker thread, objects that
+ *  are also accessed from other threads must be thread safe, e.g. use
+ *  <b>piu_AtomicVTimer</b> instead of <b>piu_VTimer</b>
+ *
+ * @example 10kHz control loop
+ * @code
+ *  static piu_AtomicVTimer controlTimer =
+ *      PIU_ATOMIC_VTIMER_MAKE(0, piu_VTMode_Continuous, controlStep);
+ *  static piu_Button button = PIU_BUTTON_MAKE(50);
+ *
+ *  static const piu_RTTickEntry entries[] = {
+ *      PIU_RT_TICK_ATOMIC_VTIMER(&controlTimer),
+ *      PIU_RT_TICK_BUTTON(&button),
+ *  };
+ *
+ *  piu_RTTicker ticker;
+ *  piu_RTTicker_construct(&ticker, 100000, entries, 2);
+ *  piu_AtomicVTimer_startCounter(&controlTimer);
+ *  piu_RTTicker_start(&ticker, 80);
+ * @endcode
+ */
+
+
+#ifndef PIU_RT_TICKER_H
+#define PIU_RT_TICKER_H
+
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "piu_atomic.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// Number of latency histogram buckets, the last bucket collects everything
+// beyond the histogram range
+#ifndef PIU_RT_TICKER_HISTOGRAM_SIZE
+#define PIU_RT_TICKER_HISTOGRAM_SIZE 128
+#endif
+
+// Default width of a latency histogram bucket in nanoseconds
+#define PIU_RT_TICKER_BUCKET_NS 1000
+
+
+typedef struct piu_struct_RTTickEntry
+{
+    void (*tickFunc)(void* object);
+    void* object;
+} piu_RTTickEntry;
+
+
+/**
+ * @brief Use these macros to create a piu_RTTickEntry for the library types
+ * @param PTR Pointer to the object to tick
+ */
+#define PIU_RT_TICK_VTIMER(PTR)                                                \
+    {                                                                          \
+        piu_RTTicker_tickVTimer, (PTR)                                         \
+    }
+#define PIU_RT_TICK_ATOMIC_VTIMER(PTR)                                         \
+    {                                                                          \
+        piu_RTTicker_tickAtomicVTimer, (PTR)                                   \
+    }
+#define PIU_RT_TICK_BUTTON(PTR)                                                \
+    {                                                                          \
+        piu_RTTicker_tickButton, (PTR)                                         \
+    }
+
+
+typedef struct piu_struct_RTTickerStats
+{
+    uint64_t wakeups;        // Number of times the thread woke up
+    uint64_t ticks;          // Number of ticks delivered, including batches
+    uint64_t missedTicks;    // Ticks that were delivered late in a batch
+
+    uint32_t minLatencyNs;
+    uint32_t avgLatencyNs;
+    uint32_t p99LatencyNs;    // Upper edge of the histogram bucket
+    uint32_t maxLatencyNs;
+} piu_RTTickerStats;
+
+
+/**
+ * @warning All data contained in this struct should be considered private and
+ *      should only be accessed with functions starting with
+ *      <b>piu_RTTicker_</b>
+ */
+typedef struct piu_struct_RTTicker
+{
+    const piu_RTTickEntry* entries;
+    size_t entryCount;
+
+    uint32_t periodNs;
+    uint32_t bucketNs;
+
+    pthread_t thread;
+    bool flag_started;
+    bool flag_realTime;
+    PIU_ATOMIC(bool) flag_running;
+
+    PIU_ATOMIC(uint64_t) wakeups;
+    PIU_ATOMIC(uint64_t) ticks;
+    PIU_ATOMIC(uint64_t) missedTicks;
+    PIU_ATOMIC(uint64_t) latencySumNs;
+    PIU_ATOMIC(uint32_t) latencyMinNs;
+    PIU_ATOMIC(uint32_t) latencyMaxNs;
+    PIU_ATOMIC(uint32_t) histogram[PIU_RT_TICKER_HISTOGRAM_SIZE];
+} piu_RTTicker;
+
+
+/**
+ * @brief Initialize a piu_RTTicker struct
+ * @param ticker Pointer to an uninitialized piu_RTTicker struct
+ * @param periodNs Tick period in nanoseconds, e.g. 100000 for 10kHz
+ * @param entries Array of objects to tick, ticked in array order. The array
+ *      must stay valid while the ticker runs
+ * @param entryCount Number of elements in @p entries
+ * @return Pointer to the same piu_RTTicker struct passed in
+ */
+piu_RTTicker* piu_RTTicker_construct(piu_RTTicker* ticker,
+                                     uint32_t periodNs,
+                                     const piu_RTTickEntry* entries,
+                                     size_t entryCount);
+
+/**
+ * @brief Set the width of a latency histogram bucket
+ * @note Only takes effect if called before piu_RTTicker_start, the
+ *      histogram covers bucketNs * PIU_RT_TICKER_HISTOGRAM_SIZE nanoseconds
+ * @param ticker Pointer to a piu_RTTicker struct
+ * @param bucketNs Bucket width in nanoseconds, must not be 0
+ */
+void piu_RTTicker_setBucketWidth(piu_RTTicker* ticker, uint32_t bucketNs);
+
+/**
+ * @brief Start the ticker thread
+ * @param ticker Pointer to a piu_RTTicker struct
+ * @param priority SCHED_FIFO priority (1 - 99), use 0 for the default policy
+ * @return 0 on success, else the error number of the failed call
+ */
+int piu_RTTicker_start(piu_RTTicker* ticker, int priority);
+/**
+ * @brief Stop the ticker thread and wait for it to exit
+ * @note Have no effect if the ticker is not started
+ * @param ticker Pointer to a piu_RTTicker struct
+ */
+void piu_RTTicker_stop(piu_RTTicker* ticker);
+
+/**
+ * @brief Check if the ticker thread runs with SCHED_FIFO
+ * @param ticker Pointer to a piu_RTTicker struct
+ * @return @p true if the thread got SCHED_FIFO, @p false if it fell back to
+ *      the default policy or is not started
+ */
+bool piu_RTTicker_isRealTime(const piu_RTTicker* ticker);
+
+/**
+ * @brief Get tick count, missed tick and wake up latency statistics
+ * @note Can be called while the ticker runs
+ * @param ticker Pointer to a piu_RTTicker struct
+ * @param stats Pointer to a piu_RTTickerStats struct receiving the statistics
+ */
+void piu_RTTicker_getStats(const piu_RTTicker* ticker,
+                           piu_RTTickerStats* stats);
+/**
+ * @brief Clear all statistics
+ * @param ticker Pointer to a piu_RTTicker struct
+ */
+void piu_RTTicker_resetStats(piu_RTTicker* ticker);
+
+
+void piu_RTTicker_tickVTimer(void* vTimer);
+void piu_RTTicker_tickAtomicVTimer(void* vTimer);
+void piu_RTTicker_tickButton(void* button);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif    // PIU_RT_TICKER_H
@@ -34,93 +34,241 @@
 
 #include "piu_sim_uart.h"
 
+#include <stddef.h>
+#include <string.h>
 
-#define RX_COUNT_MAX PIU_SIM_UART_RX_COUNT_MAX
-#define TX_COUNT_MAX PIU_SIM_UART_TX_COUNT_MAX
 
+#define RX_IDLE PIU_SIM_UART_RX_IDLE
+
+// With a fixed format every format lookup below is a compile time constant
+#ifdef PIU_SIM_UART_FIXED_FORMAT
+#define FORMAT(simUART)  ((void)(simUART), (uint8_t)(PIU_SIM_UART_FIXED_FORMAT))
+#define FORMAT_DEFAULT   ((uint8_t)(PIU_SIM_UART_FIXED_FORMAT))
+#else
+#define FORMAT(simUART)  ((simUART)->format)
+#define FORMAT_DEFAULT   PIU_SIM_UART_FORMAT_8N1
+#endif
+
+
+static uint8_t formatDataBits(uint8_t format) { return format & 0x0F; }
+static uint8_t formatParity(uint8_t format) { return (format >> 4) & 0x03; }
+static uint8_t formatStopBits(uint8_t format)
+{
+    return (uint8_t)(((format >> 6) & 0x01) + 1);
+}
+
+// Index of the (first) stop bit, Rx ignores the second stop bit
+static uint8_t formatRxLast(uint8_t format)
+{
+    return (uint8_t)(formatDataBits(format) +
+                     (formatParity(format) != piu_SimUARTParity_None) + 1);
+}
+
+static bool formatIsValid(uint8_t format)
+{
+    return formatDataBits(format) >= 5 && formatDataBits(format) <= 9 &&
+           formatParity(format) <= piu_SimUARTParity_Odd &&
+           (format & 0x80) == 0;
+}
+
+// Parity bit value that makes the frame match the format's parity
+static bool parityBit(uint8_t format, uint16_t data)
+{
+    data ^= data >> 8;
+    data ^= data >> 4;
+    data ^= data >> 2;
+    data ^= data >> 1;
+    return (data & 0x01) ^ (formatParity(format) == piu_SimUARTParity_Odd);
+}
+
+
+static bool isPowerOfTwo(uint16_t size) { return (size & (size - 1)) == 0; }
+
+static void fifoInit(piu_SimUARTFifo* fifo, uint8_t* buffer, uint16_t size)
+{
+    fifo->buffer = size == 0 ? NULL : buffer;
+    fifo->mask   = fifo->buffer == NULL ? 0 : size - 1;
+    fifo->head   = 0;
+    fifo->tail   = 0;
+}
+
+static uint16_t fifoCount(const piu_SimUARTFifo* fifo)
+{
+    return (uint16_t)(fifo->head - fifo->tail);
+}
+
+static bool fifoPush(piu_SimUARTFifo* fifo, uint8_t val)
+{
+    if (fifo->buffer == NULL || fifoCount(fifo) > fifo->mask)
+    {
+        return false;
+    }
+    fifo->buffer[fifo->head & fifo->mask] = val;
+    ++(fifo->head);
+    return true;
+}
+
+static bool fifoPop(piu_SimUARTFifo* fifo, uint8_t* val)
+{
+    if (fifoCount(fifo) == 0)
+    {
+        return false;
+    }
+    *val = fifo->buffer[fifo->tail & fifo->mask];
+    ++(fifo->tail);
+    return true;
+}
+
+
+// Frame word sent LSB first: start bit, data bits, parity bit, stop bits,
+// followed by an end marker bit, the frame is done once only the marker is left
+static uint16_t encodeFrame(uint8_t format, uint16_t val)
+{
+    uint8_t bitCount = formatDataBits(format);
+    uint16_t frame   = val & (uint16_t)((1u << bitCount) - 1);
+
+    if (formatParity(format) != piu_SimUARTParity_None)
+    {
+        frame |= (uint16_t)(parityBit(format, frame) << bitCount);
+        ++bitCount;
+    }
+    frame |= (uint16_t)(((1u << formatStopBits(format)) - 1) << bitCount);
+    bitCount += formatStopBits(format);
+
+    return (uint16_t)((frame << 1) | (1u << (bitCount + 1)));
+}
+
+static uint16_t encodeTxFrame(const piu_SimUART* simUART, uint16_t val)
+{
+    return encodeFrame(FORMAT(simUART), val);
+}
+
+static void txOutput(piu_SimUART* simUART, bool txVal)
+{
+    if (simUART->txSetReg == NULL)
+    {
+        simUART->setTxFunc(txVal);
+    }
+    else if (simUART->txClearReg == NULL)    // single output data register
+    {
+        if (txVal)
+        {
+            *simUART->txSetReg |= simUART->txPinMask;
+        }
+        else
+        {
+            *simUART->txSetReg &= ~simUART->txPinMask;
+        }
+    }
+    else    // separate set and clear registers
+    {
+        *(txVal ? simUART->txSetReg : simUART->txClearReg) = simUART->txPinMask;
+    }
+}
 
 static void txSendBit(piu_SimUART* simUART)
 {
-    switch (simUART->txCounter)
-    {
-    case (0): {    // Start bit
-        simUART->setTxFunc(0);
-        break;
-    }
-    case (1):    // Data bits
-    case (2):
-    case (3):
-    case (4):
-    case (5):
-    case (6):
-    case (7):
-    case (8): {
-        simUART->setTxFunc(0x01 & simUART->txBuffer);
-        simUART->txBuffer = simUART->txBuffer >> 1;
-        break;
-    }
-    case (9): {    // Stop bit
-        simUART->setTxFunc(1);
-        break;
-    }
-    case (10): {    // Stop bit and set flag
-        simUART->setTxFunc(1);
+    if (simUART->txFrame > 1)    // Start, data and stop bits
+    {
+        txOutput(simUART, simUART->txFrame & 0x01);
+        simUART->txFrame >>= 1;
+    }
+    else if (simUART->txFrame == 1)    // Frame done
+    {
+        // Next byte in Tx FIFO follows the stop bit directly
+        uint8_t val = 0;
+        if (fifoPop(&simUART->txFifo, &val))
+        {
+            simUART->txBuffer = val;
+            simUART->txFrame  = encodeTxFrame(simUART, val);
+            txOutput(simUART, simUART->txFrame & 0x01);
+            simUART->txFrame >>= 1;
+            return;
+        }
+
+        // Stop bit and set flag, the last stop bit has just ended
+        txOutput(simUART, 1);
+        simUART->txFrame         = 0;
         simUART->flag_txComplete = true;
-        break;
+        if (simUART->setDEFunc != NULL)
+        {
+            simUART->setDEFunc(false);
+        }
     }
-    default:    // no tx required;
+    // else no tx required
+}
+
+static void rxFrameDone(piu_SimUART* simUART)
+{
+    const uint8_t format   = FORMAT(simUART);
+    const uint8_t dataBits = formatDataBits(format);
+
+    uint16_t data = simUART->rxBuffer & (uint16_t)((1u << dataBits) - 1);
+
+    if (formatParity(format) != piu_SimUARTParity_None &&
+        ((simUART->rxBuffer >> dataBits) & 0x01) != parityBit(format, data))
+    {
+        simUART->flag_rxParityErr = true;
         return;
     }
+    simUART->rxBuffer = data;
+
+    if (dataBits == 9 && simUART->flag_addrFilter)
+    {
+        if (data & 0x100)    // Address frame, consumed by the filter
+        {
+            simUART->flag_addrMatch = (data & 0xFF) == simUART->address;
+            return;
+        }
+        if (!simUART->flag_addrMatch)    // Traffic for other nodes
+        {
+            return;
+        }
+    }
+
+    simUART->flag_rxComplete = true;
 
-    ++(simUART->txCounter);
+    if (simUART->rxFifo.buffer != NULL &&
+        !fifoPush(&simUART->rxFifo, (uint8_t)data))
+    {
+        simUART->flag_rxOverrun = true;
+    }
 }
 
 static void rxReceiveBit(piu_SimUART* simUART, bool rxVal)
 {
-    switch (simUART->rxCounter)
+    const uint8_t rxLast = formatRxLast(FORMAT(simUART));
+
+    if (simUART->rxCounter == 0)    // Check start bit
     {
-    case (0): {    // Check start bit
         if (rxVal)
         {
-            // move rx counter to default + 1 to stop receive
-            simUART->rxCounter = RX_COUNT_MAX + 1;
+            // move rx counter to idle to stop receive
+            simUART->rxCounter = RX_IDLE;
+            return;
         }
-        else
-        {
-            // else start service, reset rx buffer
-            simUART->flag_rxComplete = false;
-            simUART->rxBuffer        = 0;
-        }
-        break;
-    }
-    case (1):    // Receive bits
-    case (2):
-    case (3):
-    case (4):
-    case (5):
-    case (6):
-    case (7):
-    case (8): {
-        simUART->rxBuffer = simUART->rxBuffer |
-                            (rxVal << (simUART->rxCounter - 1));
-        break;
-    }
-    case (9):
+
+        // else start service, reset rx buffer
+        simUART->flag_rxComplete = false;
+        simUART->rxBuffer        = 0;
+    }
+    else if (simUART->rxCounter < rxLast)    // Receive data and parity bits
+    {
+        simUART->rxBuffer |= (uint16_t)(rxVal << (simUART->rxCounter - 1));
+    }
+    else if (simUART->rxCounter == rxLast)    // Stop bit
+    {
+        simUART->rxCounter       = RX_IDLE;
+        simUART->flag_rxFrameErr = !rxVal;
         if (rxVal)    // stop-bit correct
         {
-            simUART->flag_rxComplete = true;
-            simUART->flag_rxFrameErr = false;
+            rxFrameDone(simUART);
         }
-        else    // stop-bit incorrect
-        {
-            simUART->rxCounter       = RX_COUNT_MAX + 1;
-            simUART->flag_rxFrameErr = true;
-            simUART->flag_rxComplete = false;
-        }
-        break;
-    default: {
         return;
     }
+    else
+    {
+        return;
     }
 
     ++(simUART->rxCounter);
@@ -129,8 +277,9 @@ static void rxReceiveBit(piu_SimUART* simUART, bool rxVal)
 
 piu_SimUART* piu_SimUART_construct(piu_SimUART* simUART, void (*setTxFunc)(bool))
 {
-    simUART->rxCounter = RX_COUNT_MAX + 1;
-    simUART->txCounter = TX_COUNT_MAX + 1;
+    simUART->rxCounter = RX_IDLE;
+    simUART->txFrame   = 0;
+    simUART->format    = FORMAT_DEFAULT;
 
     simUART->flag_rxFrameErr = false;
     simUART->flag_rxComplete = false;
@@ -139,12 +288,245 @@ piu_SimUART* piu_SimUART_construct(piu_SimUART* simUART, void (*setTxFunc)(bool)
     simUART->rxBuffer = 0;
     simUART->txBuffer = 0;
 
-    simUART->setTxFunc = setTxFunc;
+    simUART->setTxFunc  = setTxFunc;
+    simUART->txSetReg   = NULL;
+    simUART->txClearReg = NULL;
+    simUART->txPinMask  = 0;
+
+    fifoInit(&simUART->rxFifo, NULL, 0);
+    fifoInit(&simUART->txFifo, NULL, 0);
+    simUART->flag_rxOverrun = false;
+
+    simUART->flag_rxParityErr = false;
+    simUART->flag_addrFilter  = false;
+    simUART->flag_addrMatch   = false;
+    simUART->address          = 0;
+
+    simUART->rxOversample = 0;
+    simUART->rxSampleIdx  = 0;
+    simUART->rxVotes      = 0;
+    simUART->rxLastSample = false;
+    simUART->flag_rxNoise = false;
+
+    simUART->txPhase = 0;
+
+    simUART->setDEFunc      = NULL;
+    simUART->idleBits       = 0;
+    simUART->rxIdleCount    = 0;
+    simUART->rxLowCount     = 0;
+    simUART->flag_idleArmed = false;
+    simUART->flag_rxIdle    = false;
+    simUART->flag_rxBreak   = false;
 
     return simUART;
 }
 
 
+bool piu_SimUART_attachFifo(piu_SimUART* simUART,
+                            uint8_t* rxBuffer,
+                            uint16_t rxSize,
+                            uint8_t* txBuffer,
+                            uint16_t txSize)
+{
+    if (!isPowerOfTwo(rxSize) || !isPowerOfTwo(txSize))
+    {
+        return false;
+    }
+
+    fifoInit(&simUART->rxFifo, rxBuffer, rxSize);
+    fifoInit(&simUART->txFifo, txBuffer, txSize);
+    simUART->flag_rxOverrun = false;
+
+    return true;
+}
+
+
+bool piu_SimUART_setFormat(piu_SimUART* simUART, uint8_t format)
+{
+#ifdef PIU_SIM_UART_FIXED_FORMAT
+    if (format != FORMAT_DEFAULT)
+    {
+        return false;
+    }
+#endif
+    if (!formatIsValid(format))
+    {
+        return false;
+    }
+
+    simUART->format = format;
+    return true;
+}
+
+
+void piu_SimUART_setAddressFilter(piu_SimUART* simUART,
+                                  uint8_t address,
+                                  bool enable)
+{
+    simUART->address         = address;
+    simUART->flag_addrFilter = enable;
+    simUART->flag_addrMatch  = false;
+}
+
+
+void piu_SimUART_setTxRegisters(piu_SimUART* simUART,
+                                volatile uint32_t* setReg,
+                                volatile uint32_t* clearReg,
+                                uint32_t pinMask)
+{
+    simUART->txSetReg   = setReg;
+    simUART->txClearReg = setReg == NULL ? NULL : clearReg;
+    simUART->txPinMask  = pinMask;
+}
+
+
+bool piu_SimUART_setOversample(piu_SimUART* simUART, uint8_t ratio)
+{
+    if (ratio != 0 && ratio != 3 && ratio != 16)
+    {
+        return false;
+    }
+
+    simUART->rxOversample = ratio;
+    simUART->rxSampleIdx  = 0;
+    simUART->rxVotes      = 0;
+    simUART->rxLastSample = false;
+    return true;
+}
+
+uint8_t piu_SimUART_getOversample(piu_SimUART* simUART)
+{
+    return simUART->rxOversample;
+}
+
+
+// Idle gap and break detection on every oversampled Rx sample
+static void rxLineMonitor(piu_SimUART* simUART, bool rxVal)
+{
+    if (rxVal)
+    {
+        simUART->rxLowCount = 0;
+    }
+    else if (simUART->rxLowCount != UINT16_MAX &&
+             ++(simUART->rxLowCount) ==
+                 (uint16_t)(formatRxLast(FORMAT(simUART)) + 1) *
+                     simUART->rxOversample)
+    {
+        // Low for longer than a whole frame including its stop bit
+        simUART->flag_rxBreak = true;
+    }
+
+    if (simUART->rxCounter != RX_IDLE || !rxVal)
+    {
+        // Counting starts at the middle of the stop bit of the last frame
+        simUART->rxIdleCount    = 0;
+        simUART->flag_idleArmed = true;
+    }
+    else if (simUART->flag_idleArmed && simUART->idleBits != 0 &&
+             ++(simUART->rxIdleCount) ==
+                 simUART->idleBits * simUART->rxOversample +
+                     simUART->rxOversample / 2)
+    {
+        simUART->flag_rxIdle    = true;
+        simUART->flag_idleArmed = false;
+    }
+}
+
+static bool rxSample(piu_SimUART* simUART, bool rxVal)
+{
+    const uint8_t voteLast = simUART->rxOversample / 2 + 1;
+
+    if (simUART->rxCounter == RX_IDLE)
+    {
+        // The first low sample after a high one is the start bit's edge
+        bool edge             = simUART->rxLastSample && !rxVal;
+        simUART->rxLastSample = rxVal;
+        if (!edge)
+        {
+            return false;
+        }
+
+        simUART->rxCounter   = 0;
+        simUART->rxSampleIdx = 0;
+        simUART->rxVotes     = 0;
+    }
+
+    // Sample in the vote window
+    if (simUART->rxSampleIdx + 2 >= voteLast && simUART->rxSampleIdx <= voteLast)
+    {
+        simUART->rxVotes = (uint8_t)(simUART->rxVotes + rxVal);
+    }
+
+    if (simUART->rxSampleIdx == voteLast)
+    {
+        if (simUART->rxVotes == 1 || simUART->rxVotes == 2)
+        {
+            simUART->flag_rxNoise = true;
+        }
+        rxReceiveBit(simUART, simUART->rxVotes >= 2);
+        simUART->rxVotes = 0;
+    }
+
+    if (++(simUART->rxSampleIdx) == simUART->rxOversample)
+    {
+        simUART->rxSampleIdx = 0;
+    }
+
+    simUART->rxLastSample = rxVal;
+    return simUART->rxCounter != RX_IDLE;
+}
+
+bool piu_SimUART_rxSampleUpdate(piu_SimUART* simUART, bool rxVal)
+{
+    if (simUART->rxOversample == 0)
+    {
+        return false;
+    }
+
+    const bool busy = rxSample(simUART, rxVal);
+    rxLineMonitor(simUART, rxVal);
+    return busy;
+}
+
+
+void piu_SimUART_setDriverEnable(piu_SimUART* simUART, void (*setDEFunc)(bool))
+{
+    simUART->setDEFunc = setDEFunc;
+}
+
+void piu_SimUART_setIdleDetect(piu_SimUART* simUART, uint16_t idleBits)
+{
+    simUART->idleBits       = idleBits;
+    simUART->rxIdleCount    = 0;
+    simUART->flag_idleArmed = false;
+}
+
+
+bool piu_SimUART_fullDuplexTIMUpdate(piu_SimUART* simUART, bool rxVal)
+{
+    piu_SimUART_rxSampleUpdate(simUART, rxVal);
+
+    if (simUART->txFrame == 0)
+    {
+        // Idle Tx keeps phase 0, a new byte starts on the next update
+        simUART->txPhase = 0;
+    }
+    else
+    {
+        if (simUART->txPhase == 0)
+        {
+            txSendBit(simUART);
+        }
+        if (++(simUART->txPhase) >= simUART->rxOversample)
+        {
+            simUART->txPhase = 0;
+        }
+    }
+
+    return simUART->rxCounter != RX_IDLE || simUART->txFrame != 0;
+}
+
+
 bool piu_SimUART_GPIOUpdate(piu_SimUART* simUART, bool rxVal)
 {
     if (rxVal == 0)
@@ -158,70 +540,122 @@ bool piu_SimUART_GPIOUpdate(piu_SimUART* simUART, bool rxVal)
 
     rxReceiveBit(simUART, rxVal);
 
-    return simUART->rxCounter <= RX_COUNT_MAX;
+    return simUART->rxCounter != RX_IDLE;
 }
 
 
 bool piu_SimUART_halfDuplexTIMUpdate(piu_SimUART* simUART, bool rxVal)
 {
-    if (simUART->rxCounter <= RX_COUNT_MAX)
+    if (simUART->rxCounter != RX_IDLE)
     {
         rxReceiveBit(simUART, rxVal);
     }
-    else if (simUART->txCounter <= TX_COUNT_MAX)
+    else if (simUART->txFrame != 0)
     {
         txSendBit(simUART);
     }
 
-    return simUART->rxCounter <= RX_COUNT_MAX ||
-           simUART->txCounter <= TX_COUNT_MAX;
+    return simUART->rxCounter != RX_IDLE || simUART->txFrame != 0;
 }
 
 
 bool piu_SimUART_rxTIMUpdate(piu_SimUART* simUART, bool rxVal)
 {
-    if (simUART->rxCounter <= RX_COUNT_MAX)
+    if (simUART->rxCounter != RX_IDLE)
     {
         rxReceiveBit(simUART, rxVal);
     }
-    return simUART->rxCounter <= RX_COUNT_MAX;
+    return simUART->rxCounter != RX_IDLE;
 }
 
 bool piu_SimUART_txTIMUpdate(piu_SimUART* simUART)
 {
-    if (simUART->txCounter <= TX_COUNT_MAX)
-    {
-        txSendBit(simUART);
-    }
-    return simUART->txCounter <= TX_COUNT_MAX;
+    txSendBit(simUART);
+    return simUART->txFrame != 0;
 }
 
 
 uint8_t piu_SimUART_getRx(piu_SimUART* simUART)
 {
+    if (simUART->rxFifo.buffer != NULL)
+    {
+        uint8_t val = 0;
+        fifoPop(&simUART->rxFifo, &val);
+        return val;
+    }
+
     if (simUART->flag_rxFrameErr)
     {
         return 0;
     }
     simUART->flag_rxComplete = false;
-    return simUART->rxBuffer;
+    return (uint8_t)simUART->rxBuffer;
 }
 
 bool piu_SimUART_sendTx(piu_SimUART* simUART, uint8_t val)
+{
+    if (simUART->txFifo.buffer != NULL)
+    {
+        if (!fifoPush(&simUART->txFifo, val))
+        {
+            return false;
+        }
+        if (!simUART->flag_txComplete)    // Tx running, byte is picked up
+        {
+            return true;
+        }
+        fifoPop(&simUART->txFifo, &val);
+    }
+
+    return piu_SimUART_sendTxWord(simUART, val);
+}
+
+
+uint16_t piu_SimUART_getRxWord(piu_SimUART* simUART)
+{
+    simUART->flag_rxComplete = false;
+    return simUART->rxBuffer;
+}
+
+bool piu_SimUART_sendTxWord(piu_SimUART* simUART, uint16_t val)
 {
     if (simUART->flag_txComplete)
     {
+        // Driver enabled before the start bit goes out on the next update
+        if (simUART->setDEFunc != NULL)
+        {
+            simUART->setDEFunc(true);
+        }
         simUART->flag_txComplete = false;
         simUART->txBuffer        = val;
-        simUART->txCounter       = 0;
+        simUART->txFrame         = encodeTxFrame(simUART, val);
         return true;
     }
     return false;
 }
 
 
+uint16_t piu_SimUART_getRxCount(piu_SimUART* simUART)
+{
+    return fifoCount(&simUART->rxFifo);
+}
+
+uint16_t piu_SimUART_getTxFree(piu_SimUART* simUART)
+{
+    if (simUART->txFifo.buffer == NULL)
+    {
+        return 0;
+    }
+    return (uint16_t)(simUART->txFifo.mask + 1 - fifoCount(&simUART->txFifo));
+}
+
+
 bool piu_SimUART_getRxComplete(piu_SimUART* simUART)
 {
+    if (simUART->rxFifo.buffer != NULL)
+    {
+        return fifoCount(&simUART->rxFifo) != 0;
+    }
     return simUART->flag_rxComplete;
 }
 bool piu_SimUART_getTxComplete(piu_SimUART* simUART)
@@ -232,3 +666,294 @@ bool piu_SimUART_getRxFrameErr(piu_SimUART* simUART)
 {
     return simUART->flag_rxFrameErr;
 }
+bool piu_SimUART_getRxOverrun(piu_SimUART* simUART)
+{
+    bool flag               = simUART->flag_rxOverrun;
+    simUART->flag_rxOverrun = false;
+    return flag;
+}
+bool piu_SimUART_getRxParityErr(piu_SimUART* simUART)
+{
+    bool flag                 = simUART->flag_rxParityErr;
+    simUART->flag_rxParityErr = false;
+    return flag;
+}
+bool piu_SimUART_getRxNoise(piu_SimUART* simUART)
+{
+    bool flag             = simUART->flag_rxNoise;
+    simUART->flag_rxNoise = false;
+    return flag;
+}
+bool piu_SimUART_getRxIdle(piu_SimUART* simUART)
+{
+    bool flag            = simUART->flag_rxIdle;
+    simUART->flag_rxIdle = false;
+    return flag;
+}
+bool piu_SimUART_getRxBreak(piu_SimUART* simUART)
+{
+    bool flag             = simUART->flag_rxBreak;
+    simUART->flag_rxBreak = false;
+    return flag;
+}
+
+
+/** Buffer encode/decode ******************************************************/
+
+static size_t frameSamples(uint8_t format, uint8_t samplesPerBit)
+{
+    return (size_t)(1 + formatDataBits(format) +
+                    (formatParity(format) != piu_SimUARTParity_None) +
+                    formatStopBits(format)) *
+           samplesPerBit;
+}
+
+size_t piu_SimUART_encodePins(uint8_t format,
+                              const uint8_t* data,
+                              size_t len,
+                              uint8_t samplesPerBit,
+                              uint8_t* pins,
+                              size_t pinsSize)
+{
+    const size_t count = frameSamples(format, samplesPerBit) * len;
+    if (!formatIsValid(format) || samplesPerBit == 0 || count > pinsSize)
+    {
+        return 0;
+    }
+
+    for (size_t i = 0; i < len; ++i)
+    {
+        for (uint16_t frame = encodeFrame(format, data[i]); frame > 1;
+             frame >>= 1)
+        {
+            memset(pins, frame & 0x01, samplesPerBit);
+            pins += samplesPerBit;
+        }
+    }
+    return count;
+}
+
+size_t piu_SimUART_encodePortWords(uint8_t format,
+                                   const uint8_t* data,
+                                   size_t len,
+                                   uint8_t samplesPerBit,
+                                   uint32_t highWord,
+                                   uint32_t lowWord,
+                                   uint32_t* words,
+                                   size_t wordsSize)
+{
+    const size_t count = frameSamples(format, samplesPerBit) * len;
+    if (!formatIsValid(format) || samplesPerBit == 0 || count > wordsSize)
+    {
+        return 0;
+    }
+
+    for (size_t i = 0; i < len; ++i)
+    {
+        for (uint16_t frame = encodeFrame(format, data[i]); frame > 1;
+             frame >>= 1)
+        {
+            const uint32_t word = (frame & 0x01) ? highWord : lowWord;
+            for (uint8_t s = 0; s < samplesPerBit; ++s) { *(words++) = word; }
+        }
+    }
+    return count;
+}
+
+
+// Check the received bits of one frame (data, parity, first stop bit, LSB
+// first, start bit excluded) with the same rules as the Rx interrupt
+static uint16_t decodeFrame(uint8_t format, uint16_t bits)
+{
+    const uint8_t dataBits = formatDataBits(format);
+
+    uint16_t data = bits & (uint16_t)((1u << dataBits) - 1);
+    uint8_t stopIdx = dataBits;
+
+    if (formatParity(format) != piu_SimUARTParity_None)
+    {
+        if (((bits >> dataBits) & 0x01) != parityBit(format, data))
+        {
+            data |= PIU_SIM_UART_DECODE_PARITY_ERR;
+        }
+        ++stopIdx;
+    }
+    if (((bits >> stopIdx) & 0x01) == 0)
+    {
+        data |= PIU_SIM_UART_DECODE_FRAME_ERR;
+    }
+    return data;
+}
+
+// Line level of sample idx, pins are 0/1 bytes, port words are masked
+#define PIN_AT(PINS, MASK, IDX) ((void)(MASK), (PINS)[IDX] != 0)
+#define WORD_AT(WORDS, MASK, IDX) (((WORDS)[IDX] & (MASK)) != 0)
+
+// Samples tested per step when scanning port words for an edge
+#define WORD_SCAN_BLOCK 8
+
+// First sample at or after i with the given level, count if none
+static size_t findLevelPins(const uint8_t* pins,
+                            uint32_t pinMask,
+                            size_t i,
+                            size_t count,
+                            bool level)
+{
+    (void)pinMask;
+    if (i >= count)
+    {
+        return count;
+    }
+    if (!level)
+    {
+        // Idle runs are long, memchr scans them many bytes at a time
+        const uint8_t* low = memchr(pins + i, 0, count - i);
+        return low == NULL ? count : (size_t)(low - pins);
+    }
+
+    // Low runs end at the first non zero byte, 8 bytes per step
+    while (i + 8 <= count)
+    {
+        uint64_t block;
+        memcpy(&block, pins + i, 8);
+        if (block != 0)
+        {
+            break;
+        }
+        i += 8;
+    }
+    while (i < count && !PIN_AT(pins, pinMask, i)) { ++i; }
+    return i;
+}
+
+static size_t findLevelWords(const uint32_t* words,
+                             uint32_t pinMask,
+                             size_t i,
+                             size_t count,
+                             bool level)
+{
+    // A block at the other level is skipped with one branch, the AND and OR
+    // reductions over the masked words have no branches
+    while (i + WORD_SCAN_BLOCK <= count)
+    {
+        uint32_t any = 0;
+        uint32_t all = pinMask;
+        for (uint8_t k = 0; k < WORD_SCAN_BLOCK; ++k)
+        {
+            const uint32_t sample = words[i + k] & pinMask;
+            any |= sample;
+            all &= sample;
+        }
+        if ((level ? any : all ^ pinMask) != 0)
+        {
+            break;
+        }
+        i += WORD_SCAN_BLOCK;
+    }
+    while (i < count && WORD_AT(words, pinMask, i) != level) { ++i; }
+    return i;
+}
+
+// One decoder per sample type, the sample access is fixed at compile time
+// instead of checked on every sample. Bits are sampled one center at a time,
+// a frame only has a handful of them, the scans between frames dominate.
+#define PIU_SIM_UART_DECODE_DEFINE(NAME, SAMPLE_T, SAMPLE_AT, FIND_LEVEL)      \
+    static inline bool NAME##Bit(const SAMPLE_T* samples,                      \
+                                 uint32_t pinMask,                             \
+                                 size_t center,                                \
+                                 uint8_t samplesPerBit)                        \
+    {                                                                          \
+        if (samplesPerBit < 3)                                                 \
+        {                                                                      \
+            return SAMPLE_AT(samples, pinMask, center);                        \
+        }                                                                      \
+        return SAMPLE_AT(samples, pinMask, center - 1) +                       \
+                   SAMPLE_AT(samples, pinMask, center) +                       \
+                   SAMPLE_AT(samples, pinMask, center + 1) >=                  \
+               2;                                                              \
+    }                                                                          \
+                                                                               \
+    static size_t NAME(uint8_t format,                                         \
+                       const SAMPLE_T* samples,                                \
+                       uint32_t pinMask,                                       \
+                       size_t count,                                           \
+                       uint8_t samplesPerBit,                                  \
+                       uint16_t* out,                                          \
+                       size_t outSize)                                         \
+    {                                                                          \
+        if (!formatIsValid(format) || samplesPerBit == 0)                      \
+        {                                                                      \
+            return 0;                                                          \
+        }                                                                      \
+                                                                               \
+        const uint8_t stopIdx = formatRxLast(format);                          \
+        const size_t span     = (size_t)stopIdx * samplesPerBit +              \
+                            samplesPerBit / 2 + (samplesPerBit < 3 ? 1 : 2);   \
+                                                                               \
+        size_t frames = 0;                                                     \
+        size_t i      = 0;                                                     \
+        bool idle     = true; /* Line before the buffer counts as idle */      \
+        while (frames < outSize)                                               \
+        {                                                                      \
+            /* Line must be idle high before the start bit's falling edge */   \
+            if (!idle)                                                         \
+            {                                                                  \
+                i = FIND_LEVEL(samples, pinMask, i, count, true);              \
+            }                                                                  \
+            idle = false;                                                      \
+            i    = FIND_LEVEL(samples, pinMask, i, count, false);              \
+            if (i + span > count)                                              \
+            {                                                                  \
+                break;                                                         \
+            }                                                                  \
+                                                                               \
+            const size_t start = i + samplesPerBit / 2;                        \
+            if (NAME##Bit(samples, pinMask, start, samplesPerBit))             \
+            {                                                                  \
+                continue; /* False start */                                    \
+            }                                                                  \
+                                                                               \
+            uint16_t bits = 0;                                                 \
+            for (uint8_t b = 1; b <= stopIdx; ++b)                             \
+            {                                                                  \
+                const size_t center = start + (size_t)b * samplesPerBit;       \
+                bits |= (uint16_t)(                                            \
+                    NAME##Bit(samples, pinMask, center, samplesPerBit)         \
+                    << (b - 1));                                               \
+            }                                                                  \
+            out[frames++] = decodeFrame(format, bits);                         \
+                                                                               \
+            i = start + (size_t)stopIdx * samplesPerBit;                       \
+        }                                                                      \
+        return frames;                                                         \
+    }
+
+PIU_SIM_UART_DECODE_DEFINE(decodePinSamples, uint8_t, PIN_AT, findLevelPins)
+PIU_SIM_UART_DECODE_DEFINE(decodeWordSamples,
+                           uint32_t,
+                           WORD_AT,
+                           findLevelWords)
+
+
+size_t piu_SimUART_decodePins(uint8_t format,
+                              const uint8_t* pins,
+                              size_t count,
+                              uint8_t samplesPerBit,
+                              uint16_t* out,
+                              size_t outSize)
+{
+    return decodePinSamples(
+        format, pins, 0, count, samplesPerBit, out, outSize);
+}
+
+size_t piu_SimUART_decodePortWords(uint8_t format,
+                                   const uint32_t* words,
+                                   size_t count,
+                                   uint8_t samplesPerBit,
+                                   uint32_t pinMask,
+                                   uint16_t* out,
+                                   size_t outSize)
+{
+    return decodeWordSamples(
+        format, words, pinMask, count, samplesPerBit, out, outSize);
+}
@@ -40,6 +40,8 @@
  * accuracy software timer interrupt for consecutive input detections.
  * @note For UART to work at a certain baud, the timer interrupt interval should
  * be set to trigger once for every bit
+ * @note For multi-byte transfers attach Rx/Tx FIFOs with
+ * <b>piu_SimUART_attachFifo</b>
  *
  * @example This example is Sim/Soft UART in half duplex mode.
  *  For <b>Rx</b>, assuming the <b>piu_SimUART</b> variable is named
@@ -78,6 +80,26 @@
  *  piu_SimUART_sendTx(&sUART, 0x55);
  *  TIMER_StartCounter();
  * @endcode
+ * @n @n
+ * @example For oversampled <b>Rx</b> no GPIO interrupt and no busy-wait is
+ * needed, a free running timer samples the Rx pin 3 or 16 times per bit:
+ * @code
+ *  piu_SimUART_setOversample(&sUART, 16);
+ *
+ *  void TIMER_16X_BAUD_IT_HANDLE(void)
+ *  {
+ *      piu_SimUART_rxSampleUpdate(&sUART, GPIO_1);
+ *  }
+ * @endcode
+ * @n @n
+ * @example For full duplex on the same single timer, Tx is sent on every 16th
+ * update, independent of the Rx phase:
+ * @code
+ *  void TIMER_16X_BAUD_IT_HANDLE(void)
+ *  {
+ *      piu_SimUART_fullDuplexTIMUpdate(&sUART, GPIO_1);
+ *  }
+ * @endcode
  */
 
 
@@ -90,12 +112,65 @@ extern "C" {
 
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 
+// Bit counts of the default 8N1 frame
 #define PIU_SIM_UART_RX_COUNT_MAX 9
 #define PIU_SIM_UART_TX_COUNT_MAX 10
 
+// rxCounter value while no Rx is in progress
+#define PIU_SIM_UART_RX_IDLE 0xFF
+
+// Error bits of frames returned by piu_SimUART_decodePins/decodePortWords
+#define PIU_SIM_UART_DECODE_FRAME_ERR  0x4000
+#define PIU_SIM_UART_DECODE_PARITY_ERR 0x8000
+
+
+typedef enum piu_enum_SimUARTParity
+{
+    piu_SimUARTParity_None,
+    piu_SimUARTParity_Even,
+    piu_SimUARTParity_Odd,
+} piu_SimUARTParity;
+
+
+/**
+ * @brief Pack a frame format into one byte, see piu_SimUART_setFormat
+ * @param DATA_BITS Number of data bits, 5 to 9
+ * @param PARITY A piu_SimUARTParity value
+ * @param STOP_BITS Number of stop bits, 1 or 2
+ */
+#define PIU_SIM_UART_FORMAT(DATA_BITS, PARITY, STOP_BITS)                      \
+    ((uint8_t)((DATA_BITS) | ((PARITY) << 4) | (((STOP_BITS)-1) << 6)))
+
+#define PIU_SIM_UART_FORMAT_8N1                                                \
+    PIU_SIM_UART_FORMAT(8, piu_SimUARTParity_None, 1)
+
+/**
+ * @note Define <b>PIU_SIM_UART_FIXED_FORMAT</b> to a format when compiling
+ *      the library, e.g. @p -DPIU_SIM_UART_FIXED_FORMAT=PIU_SIM_UART_FORMAT_8N1
+ *      , to make every piu_SimUART use that format. The bit handlers are then
+ *      specialized by the compiler and the per instance format is ignored
+ */
+
+
+/**
+ * @brief Single producer single consumer byte ring buffer, see
+ *      piu_SimUART_attachFifo
+ * @note @p head and @p tail are free running, the index into @p buffer is
+ *      masked with @p mask, the buffer size must be a power of two
+ */
+typedef struct piu_struct_SimUARTFifo
+{
+    uint8_t* buffer;
+    uint16_t mask;
+
+    volatile uint16_t head;    // Written by the producer only
+    volatile uint16_t tail;    // Written by the consumer only
+} piu_SimUARTFifo;
+
 
 typedef struct piu_struct_SimUART
 {
@@ -104,13 +179,47 @@ typedef struct piu_struct_SimUART
 
     bool flag_rxFrameErr;
 
-    uint8_t rxBuffer;
-    uint8_t txBuffer;
+    uint16_t rxBuffer;
+    uint16_t txBuffer;
 
     uint8_t rxCounter;
-    uint8_t txCounter;
+    uint16_t txFrame;    // Remaining Tx bits LSB first, 0 when idle
+
+    uint8_t format;
 
     void (*setTxFunc)(bool txVal);
+
+    piu_SimUARTFifo rxFifo;
+    piu_SimUARTFifo txFifo;
+
+    bool flag_rxOverrun;
+
+    volatile uint32_t* txSetReg;
+    volatile uint32_t* txClearReg;
+    uint32_t txPinMask;
+
+    bool flag_rxParityErr;
+
+    bool flag_addrFilter;
+    bool flag_addrMatch;
+    uint8_t address;
+
+    uint8_t rxOversample;    // Samples per bit, 0 when not oversampling
+    uint8_t rxSampleIdx;
+    uint8_t rxVotes;
+    bool rxLastSample;
+    bool flag_rxNoise;
+
+    uint8_t txPhase;
+
+    void (*setDEFunc)(bool deVal);
+
+    uint16_t idleBits;
+    uint16_t rxIdleCount;
+    uint16_t rxLowCount;
+    bool flag_idleArmed;
+    bool flag_rxIdle;
+    bool flag_rxBreak;
 } piu_SimUART;
 
 
@@ -124,9 +233,17 @@ typedef struct piu_struct_SimUART
  *      The function pointer must <b>NOT</b> be @p NULL
  */
 #define PIU_SIM_UART_MAKE(SET_TX_FUNC)                                         \
+    PIU_SIM_UART_MAKE_FORMAT(SET_TX_FUNC, PIU_SIM_UART_FORMAT_8N1)
+
+/**
+ * @brief Same as <b>PIU_SIM_UART_MAKE</b> with a frame format other than 8N1
+ * @param SET_TX_FUNC See PIU_SIM_UART_MAKE
+ * @param FORMAT Frame format created with PIU_SIM_UART_FORMAT
+ */
+#define PIU_SIM_UART_MAKE_FORMAT(SET_TX_FUNC, FORMAT)                          \
     {                                                                          \
-        false, true, false, 0, 0, PIU_SIM_UART_RX_COUNT_MAX + 1,               \
-            PIU_SIM_UART_TX_COUNT_MAX + 1, (SET_TX_FUNC)                       \
+        false, true, false, 0, 0, PIU_SIM_UART_RX_IDLE, 0, (FORMAT),           \
+            (SET_TX_FUNC)                                                      \
     }
 
 /**
@@ -141,6 +258,80 @@ typedef struct piu_struct_SimUART
 piu_SimUART* piu_SimUART_construct(piu_SimUART* simUART,
                                    void (*setTxFunc)(bool));
 
+/**
+ * @brief Attach caller provided ring buffers for multi-byte Rx and Tx
+ * @note With a Tx FIFO, @p piu_SimUART_sendTx queues bytes and the timer
+ *      update starts the next byte right after the stop bit of the previous
+ *      one, without an idle bit in between. The transmission only completes
+ *      once the FIFO is empty.
+ * @note With a Rx FIFO, every correctly received byte is queued,
+ *      @p piu_SimUART_getRx returns the oldest byte. If the FIFO is full the
+ *      new byte is dropped and the overrun flag is set.
+ * @note Should be called before any transmission starts
+ * @param simUART Pointer to a piu_SimUART struct
+ * @param rxBuffer Rx FIFO storage, @p NULL for no Rx FIFO
+ * @param rxSize Size of @p rxBuffer in bytes, must be a power of two
+ * @param txBuffer Tx FIFO storage, @p NULL for no Tx FIFO
+ * @param txSize Size of @p txBuffer in bytes, must be a power of two
+ * @return <b>true</b> if the buffers are attached, <b>false</b> if a size is
+ *      not a power of two and nothing is changed
+ */
+bool piu_SimUART_attachFifo(piu_SimUART* simUART,
+                            uint8_t* rxBuffer,
+                            uint16_t rxSize,
+                            uint8_t* txBuffer,
+                            uint16_t txSize);
+
+/**
+ * @brief Change the frame format
+ * @note Should be called while no Rx or Tx is in progress
+ * @note With 9 data bits, bytes passed through the FIFOs only carry the lower
+ *      8 bits, use @p piu_SimUART_sendTxWord and @p piu_SimUART_getRxWord for
+ *      the 9th bit
+ * @param simUART Pointer to a piu_SimUART struct
+ * @param format Frame format created with PIU_SIM_UART_FORMAT
+ * @return <b>true</b> if the format is set, <b>false</b> if the format is
+ *      invalid, or differs from <b>PIU_SIM_UART_FIXED_FORMAT</b> when that is
+ *      defined, and nothing is changed
+ */
+bool piu_SimUART_setFormat(piu_SimUART* simUART, uint8_t format);
+
+/**
+ * @brief Enable 9-bit multidrop address filtering
+ * @note Only works with 9 data bits. A frame with the 9th bit set is an
+ *      address frame, it is consumed by the filter and selects (or
+ *      deselects) this node. Data frames are dropped in the Rx interrupt
+ *      until an address frame matching @p address is received
+ * @param simUART Pointer to a piu_SimUART struct
+ * @param address Address of this node
+ * @param enable <b>true</b> to enable filtering, <b>false</b> to receive all
+ *      frames
+ */
+void piu_SimUART_setAddressFilter(piu_SimUART* simUART,
+                                  uint8_t address,
+                                  bool enable);
+
+/**
+ * @brief Drive the Tx pin by writing GPIO registers directly instead of
+ *      calling @p setTxFunc for every bit
+ * @note The whole frame is prepared as one word when the transmission starts,
+ *      every timer update only shifts out one bit and writes one register
+ * @note With @p clearReg, high is written as @p pinMask to @p setReg and low
+ *      as @p pinMask to @p clearReg (BSRR/BRR style set and reset registers).
+ *      Without @p clearReg, @p setReg is an output data register and the pin
+ *      is changed with a read-modify-write
+ * @param simUART Pointer to a piu_SimUART struct
+ * @param setReg Set (or output data) register, @p NULL to go back to
+ *      @p setTxFunc
+ * @param clearReg Clear register, @p NULL to use read-modify-write on
+ *      @p setReg
+ * @param pinMask Bit mask of the Tx pin in the registers
+ */
+void piu_SimUART_setTxRegisters(piu_SimUART* simUART,
+                                volatile uint32_t* setReg,
+                                volatile uint32_t* clearReg,
+                                uint32_t pinMask);
+
 /**
  * @brief Called in timer interrupt, see example at the start of the file
  * @note This is for half duplex operation, when both Rx and Tx share the same
@@ -174,6 +365,71 @@ bool piu_SimUART_rxTIMUpdate(piu_SimUART* simUART, bool rxVal);
  *      is complete and the timer can stop and reset
  */
 bool piu_SimUART_txTIMUpdate(piu_SimUART* simUART);
+/**
+ * @brief Enable oversampled Rx, see piu_SimUART_rxSampleUpdate
+ * @param simUART Pointer to a piu_SimUART struct
+ * @param ratio Samples per bit, 3 or 16, 0 to disable oversampling
+ * @return <b>true</b> if the ratio is set, <b>false</b> if the ratio is not
+ *      supported and nothing is changed
+ */
+bool piu_SimUART_setOversample(piu_SimUART* simUART, uint8_t ratio);
+/**
+ * @brief Get the Rx oversampling ratio
+ * @param simUART Pointer to a piu_SimUART struct
+ * @return Samples per bit, 0 when not oversampling
+ */
+uint8_t piu_SimUART_getOversample(piu_SimUART* simUART);
+/**
+ * @brief Call in a timer interrupt running at @p ratio times the baud rate
+ * @note The start bit edge is found from the samples, every bit is then
+ *      decided by a majority vote over the 3 samples in the middle of the bit
+ *      (all 3 samples at 3x). If the voted samples disagree the noise flag is
+ *      set
+ * @note Replaces @p piu_SimUART_GPIOUpdate and @p piu_SimUART_rxTIMUpdate,
+ *      should <b>NOT</b> be used together with them
+ * @param simUART Pointer to a piu_SimUART struct
+ * @param rxVal The Rx pin's value
+ * @return <b>true</b> if Rx is in progress, <b>false</b> if waiting for a
+ *      start bit
+ */
+bool piu_SimUART_rxSampleUpdate(piu_SimUART* simUART, bool rxVal);
+
+/**
+ * @brief Call in a timer interrupt running at the oversample ratio times the
+ *      baud rate for full duplex operation with a single timer
+ * @note Rx works like @p piu_SimUART_rxSampleUpdate, aligned to the start
+ *      edge of every received frame. Tx outputs one bit every ratio updates on
+ *      its own phase, starting on the first update after
+ *      @p piu_SimUART_sendTx, so neither direction waits for the other
+ * @note Requires @p piu_SimUART_setOversample, without oversampling only Tx
+ *      runs, one bit per update
+ * @param simUART Pointer to a piu_SimUART struct
+ * @param rxVal The Rx pin's value
+ * @return <b>true</b> if Rx or Tx is in progress, <b>false</b> otherwise
+ */
+bool piu_SimUART_fullDuplexTIMUpdate(piu_SimUART* simUART, bool rxVal);
+
+/**
+ * @brief Set a RS-485 driver enable (DE/RE) callback
+ * @note The callback is called with <b>true</b> when a transmission starts,
+ *      before the first start bit is output, and with <b>false</b> in the
+ *      update right after the last stop bit, once the Tx FIFO is empty
+ * @param simUART Pointer to a piu_SimUART struct
+ * @param setDEFunc Function setting the driver enable pin, @p NULL to disable
+ */
+void piu_SimUART_setDriverEnable(piu_SimUART* simUART, void (*setDEFunc)(bool));
+/**
+ * @brief Set the idle gap that marks the end of a message, e.g. Modbus RTU's
+ *      3.5 characters (39 bit times for 11 bit characters)
+ * @note Requires oversampled Rx, the free running sample timer measures the
+ *      gap so no separate software timer is needed
+ * @note The gap is measured from the end of the last frame, the idle flag is
+ *      set once per gap
+ * @param simUART Pointer to a piu_SimUART struct
+ * @param idleBits Gap length in bit times, 0 to disable
+ */
+void piu_SimUART_setIdleDetect(piu_SimUART* simUART, uint16_t idleBits);
+
 /**
  * @brief Called in GPIO interrupt, see example at the start of the file
  * @param simUART Pointer to a piu_SimUART struct
@@ -189,6 +445,8 @@ bool piu_SimUART_GPIOUpdate(piu_SimUART* simUART, bool rxVal);
  * @note Return value is invalid if @p flag_rxFrameErr is <b>true</b>
  * @note Trying to read rx when rx complete is not true may result in invalid
  *      result
+ * @note With a Rx FIFO attached, removes and returns the oldest byte in the
+ *      FIFO, returns 0 if the FIFO is empty
  * @param simUART Pointer to a piu_SimUART struct
  * @return The latest rx result
  */
@@ -196,13 +454,47 @@ uint8_t piu_SimUART_getRx(piu_SimUART* simUART);
 /**
  * @brief Configure sim UART to send data
  * @note Must enable timer & timer interrupt for data to actually be sent
+ * @note With a Tx FIFO attached, the byte is queued and sent after the bytes
+ *      already in the FIFO
  * @param simUART Pointer to a piu_SimUART struct
  * @param val The 8 bits of data to send
  * @return <b>true</b> if data is set, <b>false</b> if the previous tx has not
- *      finished and the new value could not be sent
+ *      finished (or the Tx FIFO is full) and the new value could not be sent
  */
 bool piu_SimUART_sendTx(piu_SimUART* simUART, uint8_t val);
 
+/**
+ * @brief Get the latest received frame including the 9th data bit
+ * @note Does not touch the Rx FIFO
+ * @param simUART Pointer to a piu_SimUART struct
+ * @return The latest rx result
+ */
+uint16_t piu_SimUART_getRxWord(piu_SimUART* simUART);
+/**
+ * @brief Send a frame including the 9th data bit, e.g. a multidrop address
+ * @note Does not use the Tx FIFO, only starts when the previous Tx has
+ *      completed. Bytes queued with @p piu_SimUART_sendTx afterwards follow
+ *      this frame
+ * @param simUART Pointer to a piu_SimUART struct
+ * @param val The data bits to send
+ * @return <b>true</b> if data is set, <b>false</b> if the previous tx has not
+ *      finished
+ */
+bool piu_SimUART_sendTxWord(piu_SimUART* simUART, uint16_t val);
+
+/**
+ * @brief Get the number of received bytes waiting in the Rx FIFO
+ * @param simUART Pointer to a piu_SimUART struct
+ * @return Number of bytes in the Rx FIFO, 0 if no Rx FIFO is attached
+ */
+uint16_t piu_SimUART_getRxCount(piu_SimUART* simUART);
+/**
+ * @brief Get the number of bytes that can still be queued for Tx
+ * @param simUART Pointer to a piu_SimUART struct
+ * @return Free space in the Tx FIFO, 0 if no Tx FIFO is attached
+ */
+uint16_t piu_SimUART_getTxFree(piu_SimUART* simUART);
+
 /**
  * @brief Get if the latest rx has completed and has not yet been retrieved
  * @param simUART Pointer to a piu_SimUART struct
@@ -223,6 +515,141 @@ bool piu_SimUART_getTxComplete(piu_SimUART* simUART);
  * otherwise
  */
 bool piu_SimUART_getRxFrameErr(piu_SimUART* simUART);
+/**
+ * @brief Get if a received byte was dropped because the Rx FIFO was full
+ * @note The flag will be cleared automatically when this function is called
+ * @param simUART Pointer to a piu_SimUART struct
+ * @return <b>true</b> if a byte was dropped since the last call, <b>false</b>
+ *      otherwise
+ */
+bool piu_SimUART_getRxOverrun(piu_SimUART* simUART);
+/**
+ * @brief Get if a received frame was dropped because of a parity error
+ * @note The flag will be cleared automatically when this function is called
+ * @param simUART Pointer to a piu_SimUART struct
+ * @return <b>true</b> if a parity error occurred since the last call,
+ *      <b>false</b> otherwise
+ */
+bool piu_SimUART_getRxParityErr(piu_SimUART* simUART);
+/**
+ * @brief Get if the oversampled Rx saw disagreeing samples within a bit
+ * @note The flag will be cleared automatically when this function is called
+ * @param simUART Pointer to a piu_SimUART struct
+ * @return <b>true</b> if noise was detected since the last call, <b>false</b>
+ *      otherwise
+ */
+bool piu_SimUART_getRxNoise(piu_SimUART* simUART);
+/**
+ * @brief Get if the line has been idle for the gap set with
+ *      piu_SimUART_setIdleDetect after a frame
+ * @note The flag will be cleared automatically when this function is called
+ * @param simUART Pointer to a piu_SimUART struct
+ * @return <b>true</b> if an idle gap ended a message since the last call,
+ *      <b>false</b> otherwise
+ */
+bool piu_SimUART_getRxIdle(piu_SimUART* simUART);
+/**
+ * @brief Get if the oversampled Rx saw a line break, the line held low for
+ *      longer than a whole frame
+ * @note The flag will be cleared automatically when this function is called
+ * @param simUART Pointer to a piu_SimUART struct
+ * @return <b>true</b> if a break was detected since the last call,
+ *      <b>false</b> otherwise
+ */
+bool piu_SimUART_getRxBreak(piu_SimUART* simUART);
+
+
+/**
+ * @brief Encode bytes into a Tx waveform of pin states, e.g. for a logic
+ *      pattern generator or a bit-band DMA target
+ * @note Frames follow each other without idle time in between
+ * @param format Frame format created with PIU_SIM_UART_FORMAT
+ * @param data Bytes to encode
+ * @param len Number of bytes
+ * @param samplesPerBit Number of samples each bit is held for
+ * @param pins Output buffer, one 0/1 byte per sample
+ * @param pinsSize Size of @p pins
+ * @return Number of samples written, 0 if @p pins is too small or an argument
+ *      is invalid
+ */
+size_t piu_SimUART_encodePins(uint8_t format,
+                              const uint8_t* data,
+                              size_t len,
+                              uint8_t samplesPerBit,
+                              uint8_t* pins,
+                              size_t pinsSize);
+/**
+ * @brief Encode bytes into a Tx waveform of GPIO port words for DMA-to-GPIO
+ * @note For a BSRR style register use the pin mask as @p highWord and the pin
+ *      mask shifted into the reset half as @p lowWord
+ * @param format Frame format created with PIU_SIM_UART_FORMAT
+ * @param data Bytes to encode
+ * @param len Number of bytes
+ * @param samplesPerBit Number of words each bit is held for
+ * @param highWord Word written while the line is high
+ * @param lowWord Word written while the line is low
+ * @param words Output buffer
+ * @param wordsSize Number of words in @p words
+ * @return Number of words written, 0 if @p words is too small or an argument
+ *      is invalid
+ */
+size_t piu_SimUART_encodePortWords(uint8_t format,
+                                   const uint8_t* data,
+                                   size_t len,
+                                   uint8_t samplesPerBit,
+                                   uint32_t highWord,
+                                   uint32_t lowWord,
+                                   uint32_t* words,
+                                   size_t wordsSize);
+
+/**
+ * @brief Decode a captured buffer of pin states into frames
+ * @note Uses the same frame rules as the Rx interrupt: the line must be high
+ *      before a start bit, each bit is sampled at its center (majority of 3
+ *      samples with 3 or more samples per bit), only the first stop bit is
+ *      checked. The line before the buffer counts as idle, a buffer starting
+ *      low starts with a start bit, so encoder output decodes as is
+ * @note The idle and start edge searches between frames scan several samples
+ *      per step, bits inside a frame are sampled one by one as there are only
+ *      a few of them, the decoder is not SIMD beyond what the compiler
+ *      generates for these scans
+ * @param format Frame format created with PIU_SIM_UART_FORMAT
+ * @param pins Captured samples, one 0/1 byte per sample
+ * @param count Number of samples
+ * @param samplesPerBit Number of samples per bit
+ * @param out Decoded frames, the data bits ORed with
+ *      <b>PIU_SIM_UART_DECODE_FRAME_ERR</b> and
+ *      <b>PIU_SIM_UART_DECODE_PARITY_ERR</b>
+ * @param outSize Maximum number of frames to decode
+ * @return Number of frames written to @p out, an incomplete frame at the end
+ *      of the buffer is not decoded
+ */
+size_t piu_SimUART_decodePins(uint8_t format,
+                              const uint8_t* pins,
+                              size_t count,
+                              uint8_t samplesPerBit,
+                              uint16_t* out,
+                              size_t outSize);
+/**
+ * @brief Decode a captured buffer of port words into frames
+ * @note See piu_SimUART_decodePins, the edge searches test 8 words per step
+ *      with a branch free AND/OR reduction of the masked words
+ * @param format Frame format created with PIU_SIM_UART_FORMAT
+ * @param words Captured port words
+ * @param count Number of words
+ * @param samplesPerBit Number of words per bit
+ * @param pinMask Bit mask of the Rx pin in the port words
+ * @param out Decoded frames, see piu_SimUART_decodePins
+ * @param outSize Maximum number of frames to decode
+ * @return Number of frames written to @p out
+ */
+size_t piu_SimUART_decodePortWords(uint8_t format,
+                                   const uint32_t* words,
+                                   size_t count,
+                                   uint8_t samplesPerBit,
+                                   uint32_t pinMask,
+                                   uint16_t* out,
+                                   size_t outSize);
 
 
 #ifdef __cplusplus
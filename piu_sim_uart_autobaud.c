@@ -0,0 +1,201 @@
+//
+// Created by YthanZhang on 2026/10/19.
+//
+/*******************************************************************************
+ * Copyright 2021 Ythan(Ethan) Zhang
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************
+ * This software component is licensed by Ythan Zhang under the
+ *                           BSD-2-Clause license.
+ * You may not use this file except in compliance with the license.
+ * You may obtain a copy of the License at: opensource.org/licenses/BSD-2-Clause
+ ******************************************************************************/
+
+
+#include "piu_sim_uart_autobaud.h"
+
+#include <stddef.h>
+
+
+// A UART frame is over 10 bit times after the start edge, 8N1 assumed
+#define FRAME_BITS 10
+
+
+static uint16_t elapsed(piu_SimUARTAutoBaud* autoBaud, uint16_t since)
+{
+    return (uint16_t)(piu_VTimer_getCounter(autoBaud->clock) - since);
+}
+
+// Candidate closest to the estimate, 0 if none is within 1/8 of it
+static uint16_t matchBitTime(const piu_SimUARTAutoBaud* autoBaud,
+                             uint16_t estimate)
+{
+    uint16_t best     = 0;
+    uint16_t bestDiff = UINT16_MAX;
+    for (uint8_t i = 0; i < autoBaud->bitTimeCount; ++i)
+    {
+        const uint16_t candidate = autoBaud->bitTimes[i];
+        const uint16_t diff      = candidate > estimate
+                                       ? (uint16_t)(candidate - estimate)
+                                       : (uint16_t)(estimate - candidate);
+        if (diff <= candidate / 8 && diff < bestDiff)
+        {
+            best     = candidate;
+            bestDiff = diff;
+        }
+    }
+    return best;
+}
+
+static uint16_t maxBitTime(const piu_SimUARTAutoBaud* autoBaud)
+{
+    uint16_t max = 0;
+    for (uint8_t i = 0; i < autoBaud->bitTimeCount; ++i)
+    {
+        if (autoBaud->bitTimes[i] > max)
+        {
+            max = autoBaud->bitTimes[i];
+        }
+    }
+    return max;
+}
+
+
+piu_SimUARTAutoBaud* piu_SimUARTAutoBaud_construct(
+    piu_SimUARTAutoBaud* autoBaud,
+    piu_VTimer* clock,
+    const uint16_t* bitTimes,
+    uint8_t bitTimeCount,
+    void (*setBitTime)(uint16_t bitTime))
+{
+    autoBaud->clock        = clock;
+    autoBaud->bitTimes     = bitTimes;
+    autoBaud->bitTimeCount = bitTimes == NULL ? 0 : bitTimeCount;
+    autoBaud->setBitTime   = setBitTime;
+
+    piu_SimUARTAutoBaud_restart(autoBaud);
+
+    return autoBaud;
+}
+
+
+void piu_SimUARTAutoBaud_edge(piu_SimUARTAutoBaud* autoBaud, bool rxVal)
+{
+    if (autoBaud->flag_locked)
+    {
+        return;
+    }
+
+    const uint16_t now = piu_VTimer_getCounter(autoBaud->clock);
+    if (autoBaud->edgeCount == 0)
+    {
+        if (rxVal)    // Wait for the falling edge of a start bit
+        {
+            return;
+        }
+        autoBaud->firstEdge   = now;
+        autoBaud->minInterval = UINT16_MAX;
+    }
+    else
+    {
+        const uint16_t interval = (uint16_t)(now - autoBaud->lastEdge);
+        if (interval < autoBaud->minInterval)
+        {
+            autoBaud->minInterval = interval;
+        }
+    }
+
+    autoBaud->lastEdge = now;
+    if (autoBaud->edgeCount < UINT8_MAX)
+    {
+        ++(autoBaud->edgeCount);
+    }
+}
+
+
+bool piu_SimUARTAutoBaud_update(piu_SimUARTAutoBaud* autoBaud)
+{
+    if (autoBaud->flag_locked || autoBaud->edgeCount == 0)
+    {
+        return autoBaud->flag_locked;
+    }
+
+    const uint16_t sinceStart = elapsed(autoBaud, autoBaud->firstEdge);
+
+    if (autoBaud->edgeCount == 1)
+    {
+        // No second edge within a frame at the slowest rate, a glitch
+        if (sinceStart > (uint32_t)maxBitTime(autoBaud) * FRAME_BITS)
+        {
+            autoBaud->edgeCount = 0;
+        }
+        return false;
+    }
+
+    const uint16_t bitTime = matchBitTime(autoBaud, autoBaud->minInterval);
+    if (bitTime == 0)
+    {
+        // Sync byte without an isolated bit or unsupported rate, start over
+        // once the line has been quiet for a frame at the slowest rate
+        if (elapsed(autoBaud, autoBaud->lastEdge) >
+            (uint32_t)maxBitTime(autoBaud) * FRAME_BITS)
+        {
+            autoBaud->edgeCount = 0;
+        }
+        return false;
+    }
+
+    if (sinceStart < (uint32_t)bitTime * FRAME_BITS - bitTime / 2)
+    {
+        return false;    // Frame not over yet, a shorter interval may follow
+    }
+
+    autoBaud->bitTime     = bitTime;
+    autoBaud->flag_locked = true;
+    if (autoBaud->setBitTime != NULL)
+    {
+        autoBaud->setBitTime(bitTime);
+    }
+    return true;
+}
+
+
+void piu_SimUARTAutoBaud_restart(piu_SimUARTAutoBaud* autoBaud)
+{
+    autoBaud->edgeCount   = 0;
+    autoBaud->firstEdge   = 0;
+    autoBaud->lastEdge    = 0;
+    autoBaud->minInterval = UINT16_MAX;
+    autoBaud->bitTime     = 0;
+    autoBaud->flag_locked = false;
+}
+
+
+bool piu_SimUARTAutoBaud_getLocked(const piu_SimUARTAutoBaud* autoBaud)
+{
+    return autoBaud->flag_locked;
+}
+uint16_t piu_SimUARTAutoBaud_getBitTime(const piu_SimUARTAutoBaud* autoBaud)
+{
+    return autoBaud->bitTime;
+}
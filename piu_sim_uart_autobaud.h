@@ -0,0 +1,173 @@
+//
+// Created by YthanZhang on 2026/10/19.
+//
+/*******************************************************************************
+ * Copyright 2021 Ythan(Ethan) Zhang
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************
+ * This software component is licensed by Ythan Zhang under the
+ *                           BSD-2-Clause license.
+ * You may not use this file except in compliance with the license.
+ * You may obtain a copy of the License at: opensource.org/licenses/BSD-2-Clause
+ ******************************************************************************/
+
+
+/*******************************************************************************
+ * @file piu_sim_uart_autobaud.h
+ *
+ * Baud rate detection for piu_SimUART from the edges of one sync frame. @n
+ *
+ * Every edge of the Rx line is timestamped with the counter of a free running
+ *  piu_VTimer. Edges of a UART frame fall on bit boundaries, so the shortest
+ *  interval between two edges is one bit time as long as the sync byte has an
+ *  isolated bit, e.g. 0x55 or most Modbus addresses. Once 10 bit times have
+ *  passed since the start edge the frame is over, the estimate is matched
+ *  against the candidate bit times and the closest one within 1/8 is locked
+ *  in, all within the sync frame. @n
+ *
+ * @example Detect 9600/19200/38400 baud with a 1 MHz tick
+ * @code
+ *  static piu_VTimer clock = PIU_VTIMER_MAKE(0xFFFF, piu_VTMode_Continuous,
+ *                                            NULL);
+ *  static const uint16_t bitTimes[] = {104, 52, 26};
+ *  static piu_SimUARTAutoBaud autoBaud;
+ *
+ *  piu_VTimer_startCounter(&clock);
+ *  piu_SimUARTAutoBaud_construct(&autoBaud, &clock, bitTimes, 3,
+ *                                TIMER_SetReload);
+ *
+ *  void TICK_1MHZ_IT_HANDLE(void)
+ *  {
+ *      piu_VTimer_tick(&clock);
+ *      piu_SimUARTAutoBaud_update(&autoBaud);
+ *  }
+ *
+ *  void GPIO_BOTH_EDGES_IT_HANDLE(void)
+ *  {
+ *      piu_SimUARTAutoBaud_edge(&autoBaud, GPIO_1);
+ *  }
+ * @endcode
+ */
+
+
+#ifndef PIU_SIM_UART_AUTOBAUD_H
+#define PIU_SIM_UART_AUTOBAUD_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "piu_vtimer.h"
+
+
+/**
+ * @warning All data contained in this struct should be considered private and
+ *      should only be accessed with functions starting with
+ *      <b>piu_SimUARTAutoBaud_</b>
+ */
+typedef struct piu_struct_SimUARTAutoBaud
+{
+    piu_VTimer* clock;
+
+    const uint16_t* bitTimes;
+    uint8_t bitTimeCount;
+
+    void (*setBitTime)(uint16_t bitTime);
+
+    uint8_t edgeCount;
+    uint16_t firstEdge;
+    uint16_t lastEdge;
+    uint16_t minInterval;
+
+    uint16_t bitTime;
+    bool flag_locked;
+} piu_SimUARTAutoBaud;
+
+
+/**
+ * @brief Use this function to initialize a piu_SimUARTAutoBaud struct
+ * @param autoBaud Pointer to an uninitialized piu_SimUARTAutoBaud struct
+ * @param clock Running piu_VTimer in continuous mode with a reload value of
+ *      0xFFFF, its counter is the timestamp. A frame at the slowest rate must
+ *      be shorter than 0xFFFF ticks
+ * @param bitTimes Candidate bit times in @p clock ticks
+ * @param bitTimeCount Number of candidates
+ * @param setBitTime Called with the bit time once locked, e.g. to set the
+ *      hardware timer reload, set to @p NULL for no callback
+ * @return Pointer to the same piu_SimUARTAutoBaud struct passed in
+ */
+piu_SimUARTAutoBaud* piu_SimUARTAutoBaud_construct(
+    piu_SimUARTAutoBaud* autoBaud,
+    piu_VTimer* clock,
+    const uint16_t* bitTimes,
+    uint8_t bitTimeCount,
+    void (*setBitTime)(uint16_t bitTime));
+
+/**
+ * @brief Call on every edge of the Rx line, e.g. in a GPIO interrupt on both
+ *      edges
+ * @note Edges are ignored once locked, until piu_SimUARTAutoBaud_restart
+ * @param autoBaud Pointer to a piu_SimUARTAutoBaud struct
+ * @param rxVal The Rx pin's value after the edge
+ */
+void piu_SimUARTAutoBaud_edge(piu_SimUARTAutoBaud* autoBaud, bool rxVal);
+
+/**
+ * @brief Call at least once per bit time, e.g. right after piu_VTimer_tick
+ * @note Locks in after 10 bit times from the start edge. If the estimate does
+ *      not match any candidate the sync frame is discarded and detection
+ *      starts over with the next start edge
+ * @param autoBaud Pointer to a piu_SimUARTAutoBaud struct
+ * @return <b>true</b> if locked, <b>false</b> otherwise
+ */
+bool piu_SimUARTAutoBaud_update(piu_SimUARTAutoBaud* autoBaud);
+
+/**
+ * @brief Drop the locked bit time and wait for a new sync frame
+ * @param autoBaud Pointer to a piu_SimUARTAutoBaud struct
+ */
+void piu_SimUARTAutoBaud_restart(piu_SimUARTAutoBaud* autoBaud);
+
+/**
+ * @brief Get if a bit time is locked in
+ * @param autoBaud Pointer to a piu_SimUARTAutoBaud struct
+ * @return <b>true</b> if locked, <b>false</b> otherwise
+ */
+bool piu_SimUARTAutoBaud_getLocked(const piu_SimUARTAutoBaud* autoBaud);
+/**
+ * @brief Get the locked bit time
+ * @param autoBaud Pointer to a piu_SimUARTAutoBaud struct
+ * @return The bit time in clock ticks, 0 if not locked
+ */
+uint16_t piu_SimUARTAutoBaud_getBitTime(const piu_SimUARTAutoBaud* autoBaud);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif    // PIU_SIM_UART_AUTOBAUD_H
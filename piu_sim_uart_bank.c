@@ -0,0 +1,244 @@
+//
+// Created by YthanZhang on 2026/10/19.
+//
+/*******************************************************************************
+ * Copyright 2021 Ythan(Ethan) Zhang
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************
+ * This software component is licensed by Ythan Zhang under the
+ *                           BSD-2-Clause license.
+ * You may not use this file except in compliance with the license.
+ * You may obtain a copy of the License at: opensource.org/licenses/BSD-2-Clause
+ ******************************************************************************/
+
+
+#include "piu_sim_uart_bank.h"
+
+
+static void setPlaneBit(uint32_t* plane, uint32_t bit, bool val)
+{
+    *plane = val ? (*plane | bit) : (*plane & ~bit);
+}
+
+
+piu_SimUARTBank* piu_SimUARTBank_construct(piu_SimUARTBank* bank,
+                                           uint32_t rxMask,
+                                           uint32_t txMask,
+                                           uint8_t oversample)
+{
+    bank->rxMask     = rxMask;
+    bank->txMask     = txMask;
+    bank->oversample = oversample == 16 ? 16 : 3;
+    bank->voteLast   = (uint8_t)(bank->oversample / 2 + 1);
+    bank->phase      = 0;
+
+    // Line is idle high
+    bank->rxSample[0] = rxMask;
+    bank->rxSample[1] = rxMask;
+
+    bank->rxActive = 0;
+    for (uint8_t i = 0; i < 16; ++i) { bank->rxPhase[i] = 0; }
+    for (uint8_t i = 0; i < 4; ++i) { bank->rxCount[i] = 0; }
+    for (uint8_t i = 0; i < 9; ++i) { bank->rxShift[i] = 0; }
+    for (uint8_t i = 0; i < 8; ++i) { bank->rxData[i] = 0; }
+
+    bank->rxComplete = 0;
+    bank->rxFrameErr = 0;
+    bank->rxNoise    = 0;
+
+    for (uint8_t i = 0; i < 11; ++i) { bank->txFrame[i] = 0; }
+    bank->txBusy  = 0;
+    bank->txLevel = txMask;
+
+    return bank;
+}
+
+
+static void rxVote(piu_SimUARTBank* bank, uint32_t sample)
+{
+    uint32_t closing = bank->rxPhase[bank->phase];
+    if (closing == 0)
+    {
+        return;
+    }
+
+    const uint32_t s0 = bank->rxSample[1];
+    const uint32_t s1 = bank->rxSample[0];
+    const uint32_t bits = (s0 & s1) | (s0 & sample) | (s1 & sample);
+
+    bank->rxNoise |= closing & ((s0 ^ s1) | (s0 ^ sample));
+
+    const uint32_t atStart = ~(bank->rxCount[0] | bank->rxCount[1] |
+                               bank->rxCount[2] | bank->rxCount[3]);
+    const uint32_t falseStart = closing & atStart & bits;
+    closing &= ~falseStart;
+
+    // Shift the new bit in at the top of the data/stop shift register
+    const uint32_t shift = closing & ~atStart;
+    for (uint8_t i = 0; i < 8; ++i)
+    {
+        bank->rxShift[i] = (bank->rxShift[i] & ~shift) |
+                           (bank->rxShift[i + 1] & shift);
+    }
+    bank->rxShift[8] = (bank->rxShift[8] & ~shift) | (bits & shift);
+
+    // Bit sliced increment of the received bit count
+    uint32_t carry = closing;
+    for (uint8_t i = 0; i < 4; ++i)
+    {
+        const uint32_t next = bank->rxCount[i] & carry;
+        bank->rxCount[i] ^= carry;
+        carry = next;
+    }
+
+    // 10 bits received, stop bit decides between complete and frame error
+    const uint32_t done = closing & ~bank->rxCount[0] & bank->rxCount[1] &
+                          ~bank->rxCount[2] & bank->rxCount[3];
+    const uint32_t good = done & bits;
+    for (uint8_t i = 0; i < 8; ++i)
+    {
+        bank->rxData[i] = (bank->rxData[i] & ~good) | (bank->rxShift[i] & good);
+    }
+    bank->rxComplete |= good;
+    bank->rxFrameErr |= done & ~bits;
+
+    const uint32_t ended = done | falseStart;
+    bank->rxActive &= ~ended;
+    bank->rxPhase[bank->phase] &= ~ended;
+    for (uint8_t i = 0; i < 4; ++i) { bank->rxCount[i] &= ~ended; }
+}
+
+static void txShift(piu_SimUARTBank* bank)
+{
+    uint32_t rest = 0;
+    for (uint8_t i = 1; i < 11; ++i) { rest |= bank->txFrame[i]; }
+
+    // Only the end marker left, the channel goes idle
+    const uint32_t finished = bank->txBusy & ~rest;
+    bank->txBusy &= ~finished;
+    bank->txFrame[0] &= ~finished;
+
+    bank->txLevel = (bank->txFrame[0] & bank->txBusy) |
+                    (bank->txMask & ~bank->txBusy);
+
+    for (uint8_t i = 0; i < 10; ++i) { bank->txFrame[i] = bank->txFrame[i + 1]; }
+    bank->txFrame[10] = 0;
+}
+
+
+uint32_t piu_SimUARTBank_update(piu_SimUARTBank* bank, uint32_t rxPort)
+{
+    const uint32_t sample = rxPort & bank->rxMask;
+
+    rxVote(bank, sample);
+
+    // The first low sample after a high one is a start bit's edge
+    const uint32_t edge = bank->rxSample[0] & ~sample & ~bank->rxActive;
+    if (edge != 0)
+    {
+        uint8_t closePhase = (uint8_t)(bank->phase + bank->voteLast);
+        if (closePhase >= bank->oversample)
+        {
+            closePhase = (uint8_t)(closePhase - bank->oversample);
+        }
+        bank->rxActive |= edge;
+        bank->rxPhase[closePhase] |= edge;
+    }
+
+    bank->rxSample[1] = bank->rxSample[0];
+    bank->rxSample[0] = sample;
+
+    if (bank->phase == 0)
+    {
+        txShift(bank);
+    }
+    if (++(bank->phase) == bank->oversample)
+    {
+        bank->phase = 0;
+    }
+
+    return bank->txLevel;
+}
+
+
+bool piu_SimUARTBank_sendTx(piu_SimUARTBank* bank, uint8_t channel, uint8_t val)
+{
+    if (channel >= 32)
+    {
+        return false;
+    }
+
+    const uint32_t bit = (uint32_t)1 << channel;
+    if ((bank->txMask & bit) == 0 || (bank->txBusy & bit) != 0)
+    {
+        return false;
+    }
+
+    const uint16_t frame = (uint16_t)(0x0400 | 0x0200 | ((uint16_t)val << 1));
+    for (uint8_t i = 0; i < 11; ++i)
+    {
+        setPlaneBit(&bank->txFrame[i], bit, (frame >> i) & 0x01);
+    }
+    bank->txBusy |= bit;
+
+    return true;
+}
+
+uint8_t piu_SimUARTBank_getRx(piu_SimUARTBank* bank, uint8_t channel)
+{
+    if (channel >= 32)
+    {
+        return 0;
+    }
+
+    uint8_t val = 0;
+    for (uint8_t i = 0; i < 8; ++i)
+    {
+        val = (uint8_t)(val | (((bank->rxData[i] >> channel) & 0x01) << i));
+    }
+    bank->rxComplete &= ~((uint32_t)1 << channel);
+
+    return val;
+}
+
+
+uint32_t piu_SimUARTBank_getRxComplete(const piu_SimUARTBank* bank)
+{
+    return bank->rxComplete;
+}
+uint32_t piu_SimUARTBank_getTxBusy(const piu_SimUARTBank* bank)
+{
+    return bank->txBusy;
+}
+uint32_t piu_SimUARTBank_getRxFrameErr(piu_SimUARTBank* bank)
+{
+    uint32_t flags   = bank->rxFrameErr;
+    bank->rxFrameErr = 0;
+    return flags;
+}
+uint32_t piu_SimUARTBank_getRxNoise(piu_SimUARTBank* bank)
+{
+    uint32_t flags = bank->rxNoise;
+    bank->rxNoise  = 0;
+    return flags;
+}
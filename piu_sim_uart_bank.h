@@ -0,0 +1,191 @@
+//
+// Created by YthanZhang on 2026/10/19.
+//
+/*******************************************************************************
+ * Copyright 2021 Ythan(Ethan) Zhang
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************
+ * This software component is licensed by Ythan Zhang under the
+ *                           BSD-2-Clause license.
+ * You may not use this file except in compliance with the license.
+ * You may obtain a copy of the License at: opensource.org/licenses/BSD-2-Clause
+ ******************************************************************************/
+
+
+/*******************************************************************************
+ * @file piu_sim_uart_bank.h
+ *
+ * Bank of 8N1 sim UART channels sharing one timer and one GPIO port word. @n
+ *
+ * The channel state is stored transposed into bit planes, bit n of every
+ *  plane belongs to channel n, channel n is bit n of the port word. One call
+ *  of <b>piu_SimUARTBank_update</b> samples the whole Rx port word, advances
+ *  every Rx channel with word wide operations, and returns the Tx levels of
+ *  all channels for one port write, so the interrupt time stays nearly the
+ *  same no matter how many channels are used. @n
+ *
+ * Rx is oversampled at 3x or 16x, like <b>piu_SimUART_rxSampleUpdate</b>:
+ *  every channel finds its own start bit edge, and each bit is a majority
+ *  vote over the 3 samples in the middle of the bit. Tx bits change every
+ *  3 or 16 updates. @n
+ *
+ * @example 4 Rx channels on bits 0-3 and 4 Tx channels on bits 4-7
+ * @code
+ *  piu_SimUARTBank bank;
+ *  piu_SimUARTBank_construct(&bank, 0x0F, 0xF0, 16);
+ *
+ *  void TIMER_16X_BAUD_IT_HANDLE(void)
+ *  {
+ *      uint32_t txWord = piu_SimUARTBank_update(&bank, GPIOA->IDR);
+ *      GPIOA->BSRR     = txWord | ((~txWord & 0xF0) << 16);
+ *  }
+ *
+ *  piu_SimUARTBank_sendTx(&bank, 4, 0x55);
+ *  if (piu_SimUARTBank_getRxComplete(&bank) & (1 << 2))
+ *  {
+ *      uint8_t val = piu_SimUARTBank_getRx(&bank, 2);
+ *  }
+ * @endcode
+ */
+
+
+#ifndef PIU_SIM_UART_BANK_H
+#define PIU_SIM_UART_BANK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/**
+ * @warning All data contained in this struct should be considered private and
+ *      should only be accessed with functions starting with
+ *      <b>piu_SimUARTBank_</b>
+ */
+typedef struct piu_struct_SimUARTBank
+{
+    uint32_t rxMask;
+    uint32_t txMask;
+
+    uint8_t oversample;
+    uint8_t voteLast;    // Sample index that closes a bit's vote window
+    uint8_t phase;       // Update index within the current Tx bit
+
+    uint32_t rxSample[2];    // Rx port words of the previous two updates
+
+    uint32_t rxActive;
+    uint32_t rxPhase[16];    // Active channels whose vote closes on a phase
+    uint32_t rxCount[4];     // Bits received so far
+    uint32_t rxShift[9];     // 8 data bits and stop bit, shifted in at top
+    uint32_t rxData[8];
+
+    uint32_t rxComplete;
+    uint32_t rxFrameErr;
+    uint32_t rxNoise;
+
+    uint32_t txFrame[11];    // Start, data, stop and end marker bits
+    uint32_t txBusy;
+    uint32_t txLevel;
+} piu_SimUARTBank;
+
+
+/**
+ * @brief Use this function to initialize a piu_SimUARTBank struct
+ * @param bank Pointer to an uninitialized piu_SimUARTBank struct
+ * @param rxMask Port bits used as Rx channels
+ * @param txMask Port bits used as Tx channels
+ * @param oversample Updates per bit, 16 for 16x, any other value selects 3x
+ * @return Pointer to the same piu_SimUARTBank struct passed in
+ */
+piu_SimUARTBank* piu_SimUARTBank_construct(piu_SimUARTBank* bank,
+                                           uint32_t rxMask,
+                                           uint32_t txMask,
+                                           uint8_t oversample);
+
+/**
+ * @brief Call in a timer interrupt running at @p oversample times the baud
+ *      rate
+ * @param bank Pointer to a piu_SimUARTBank struct
+ * @param rxPort The Rx port word, only bits in @p rxMask are used
+ * @return The Tx port word, only bits in @p txMask are set, idle channels are
+ *      high
+ */
+uint32_t piu_SimUARTBank_update(piu_SimUARTBank* bank, uint32_t rxPort);
+
+/**
+ * @brief Start sending a byte on a Tx channel
+ * @note The first bit is output at the next Tx bit boundary
+ * @note Must not be interrupted by piu_SimUARTBank_update, call it with the
+ *      timer interrupt disabled or from the interrupt itself
+ * @param bank Pointer to a piu_SimUARTBank struct
+ * @param channel Tx channel, a bit in @p txMask
+ * @param val The 8 bits of data to send
+ * @return <b>true</b> if data is set, <b>false</b> if the channel is not a Tx
+ *      channel or the previous byte has not been sent yet
+ */
+bool piu_SimUARTBank_sendTx(piu_SimUARTBank* bank, uint8_t channel, uint8_t val);
+/**
+ * @brief Get the received byte of a Rx channel and clear its complete bit
+ * @param bank Pointer to a piu_SimUARTBank struct
+ * @param channel Rx channel, a bit in @p rxMask
+ * @return The latest byte received on the channel
+ */
+uint8_t piu_SimUARTBank_getRx(piu_SimUARTBank* bank, uint8_t channel);
+
+/**
+ * @brief Get the channels with a received byte that has not been retrieved
+ * @param bank Pointer to a piu_SimUARTBank struct
+ * @return Bit mask of channels
+ */
+uint32_t piu_SimUARTBank_getRxComplete(const piu_SimUARTBank* bank);
+/**
+ * @brief Get the channels that are still sending
+ * @param bank Pointer to a piu_SimUARTBank struct
+ * @return Bit mask of channels
+ */
+uint32_t piu_SimUARTBank_getTxBusy(const piu_SimUARTBank* bank);
+/**
+ * @brief Get the channels that received a frame with a bad stop bit
+ * @note The flags will be cleared automatically when this function is called
+ * @param bank Pointer to a piu_SimUARTBank struct
+ * @return Bit mask of channels
+ */
+uint32_t piu_SimUARTBank_getRxFrameErr(piu_SimUARTBank* bank);
+/**
+ * @brief Get the channels that saw disagreeing samples within a bit
+ * @note The flags will be cleared automatically when this function is called
+ * @param bank Pointer to a piu_SimUARTBank struct
+ * @return Bit mask of channels
+ */
+uint32_t piu_SimUARTBank_getRxNoise(piu_SimUARTBank* bank);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif    // PIU_SIM_UART_BANK_H
@@ -0,0 +1,159 @@
+//
+// Created by YthanZhang on 2026/10/19.
+//
+/*******************************************************************************
+ * Copyright 2021 Ythan(Ethan) Zhang
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************
+ * This software component is licensed by Ythan Zhang under the
+ *                           BSD-2-Clause license.
+ * You may not use this file except in compliance with the license.
+ * You may obtain a copy of the License at: opensource.org/licenses/BSD-2-Clause
+ ******************************************************************************/
+
+
+#include "piu_sim_uart_wire.h"
+
+
+// Time units per Tx bit
+#define BIT_TIME ((uint32_t)1 << 16)
+
+
+static uint32_t nextRandom(piu_SimUARTWire* wire)
+{
+    uint32_t x = wire->random;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return wire->random = x;
+}
+
+
+piu_SimUARTWire* piu_SimUARTWire_construct(piu_SimUARTWire* wire,
+                                           piu_SimUART* tx,
+                                           piu_SimUART* rx,
+                                           int32_t rxSkewPpm,
+                                           uint16_t jitterPermille,
+                                           uint16_t noise,
+                                           uint32_t seed)
+{
+    wire->tx = tx;
+    wire->rx = rx;
+
+    if (piu_SimUART_getOversample(rx) == 0)
+    {
+        piu_SimUART_setOversample(rx, 16);
+    }
+
+    // A faster Rx clock has a shorter sample period
+    const int64_t period =
+        (int64_t)BIT_TIME * 1000000 /
+        ((int64_t)piu_SimUART_getOversample(rx) * (1000000 + rxSkewPpm));
+    wire->rxPeriod = period < 1 ? 1 : (uint32_t)period;
+
+    if (jitterPermille > 500)
+    {
+        jitterPermille = 500;
+    }
+    wire->jitter = (uint32_t)((uint64_t)BIT_TIME * jitterPermille / 1000);
+    wire->noise  = noise;
+    wire->random = seed == 0 ? 1 : seed;
+
+    wire->txPort = 1;
+    piu_SimUART_setTxRegisters(tx, &wire->txPort, NULL, 1);
+    wire->level        = true;
+    wire->pendingLevel = true;
+    wire->pendingAt    = 0;
+
+    wire->now    = 0;
+    wire->nextTx = 0;
+    wire->nextRx = nextRandom(wire) % wire->rxPeriod;    // Random Rx phase
+
+    wire->samples = 0;
+    wire->flips   = 0;
+
+    return wire;
+}
+
+
+void piu_SimUARTWire_run(piu_SimUARTWire* wire, uint32_t bits)
+{
+    const uint64_t end = wire->now + (uint64_t)bits * BIT_TIME;
+
+    while (true)
+    {
+        const bool txFirst = wire->nextTx <= wire->nextRx;
+        const uint64_t at  = txFirst ? wire->nextTx : wire->nextRx;
+        if (at >= end)
+        {
+            break;
+        }
+        wire->now = at;
+
+        if (txFirst)
+        {
+            piu_SimUART_txTIMUpdate(wire->tx);
+
+            const bool driven = (wire->txPort & 0x01) != 0;
+            if (driven != wire->pendingLevel)
+            {
+                wire->level        = wire->pendingLevel;
+                wire->pendingLevel = driven;
+                wire->pendingAt =
+                    at + (wire->jitter == 0
+                              ? 0
+                              : nextRandom(wire) % (wire->jitter + 1));
+            }
+            wire->nextTx += BIT_TIME;
+            continue;
+        }
+
+        if (at >= wire->pendingAt)
+        {
+            wire->level = wire->pendingLevel;
+        }
+
+        bool sample = wire->level;
+        if (wire->noise != 0 && (nextRandom(wire) & 0xFFFF) < wire->noise)
+        {
+            sample = !sample;
+            ++(wire->flips);
+        }
+        piu_SimUART_rxSampleUpdate(wire->rx, sample);
+        ++(wire->samples);
+
+        wire->nextRx += wire->rxPeriod;
+    }
+
+    wire->now = end;
+}
+
+
+uint64_t piu_SimUARTWire_getSamples(const piu_SimUARTWire* wire)
+{
+    return wire->samples;
+}
+uint64_t piu_SimUARTWire_getFlips(const piu_SimUARTWire* wire)
+{
+    return wire->flips;
+}
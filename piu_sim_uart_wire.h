@@ -0,0 +1,150 @@
+//
+// Created by YthanZhang on 2026/10/19.
+//
+/*******************************************************************************
+ * Copyright 2021 Ythan(Ethan) Zhang
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************
+ * This software component is licensed by Ythan Zhang under the
+ *                           BSD-2-Clause license.
+ * You may not use this file except in compliance with the license.
+ * You may obtain a copy of the License at: opensource.org/licenses/BSD-2-Clause
+ ******************************************************************************/
+
+
+/*******************************************************************************
+ * @file piu_sim_uart_wire.h
+ *
+ * Deterministic virtual wire between two piu_SimUART instances, for host side
+ * tests and benchmarks. @n
+ *
+ * The Tx instance is updated once per bit and drives the wire through its
+ *  register output (see <b>piu_SimUART_setTxRegisters</b>). The Rx instance
+ *  samples the wire with <b>piu_SimUART_rxSampleUpdate</b> on its own clock,
+ *  which can run faster or slower than the Tx clock. Tx edges can be delayed
+ *  by a random jitter and Rx samples flipped by random noise. Time is kept in
+ *  integer units of 1/65536 bit and the random numbers come from a seeded
+ *  xorshift generator, so every run with the same settings is identical. @n
+ *
+ * @example 2% slower receiver, 10% jitter, no noise
+ * @code
+ *  piu_SimUARTWire wire;
+ *  piu_SimUARTWire_construct(&wire, &txUART, &rxUART, -20000, 100, 0, 1);
+ *
+ *  piu_SimUART_sendTx(&txUART, 0x55);
+ *  piu_SimUARTWire_run(&wire, 12);
+ * @endcode
+ */
+
+
+#ifndef PIU_SIM_UART_WIRE_H
+#define PIU_SIM_UART_WIRE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "piu_sim_uart.h"
+
+
+/**
+ * @warning All data contained in this struct should be considered private and
+ *      should only be accessed with functions starting with
+ *      <b>piu_SimUARTWire_</b>
+ */
+typedef struct piu_struct_SimUARTWire
+{
+    piu_SimUART* tx;
+    piu_SimUART* rx;
+
+    uint32_t rxPeriod;    // Time between Rx samples
+    uint32_t jitter;      // Maximum delay of a Tx edge
+    uint16_t noise;       // Chance of a flipped Rx sample, in 1/65536
+    uint32_t random;
+
+    volatile uint32_t txPort;
+    bool level;
+    bool pendingLevel;
+    uint64_t pendingAt;
+
+    uint64_t now;
+    uint64_t nextTx;
+    uint64_t nextRx;
+
+    uint64_t samples;
+    uint64_t flips;
+} piu_SimUARTWire;
+
+
+/**
+ * @brief Use this function to initialize a piu_SimUARTWire struct
+ * @note Redirects the Tx output of @p tx to the wire, and enables 16x
+ *      oversampling on @p rx if no oversampling is set
+ * @param wire Pointer to an uninitialized piu_SimUARTWire struct
+ * @param tx Transmitting piu_SimUART
+ * @param rx Receiving piu_SimUART
+ * @param rxSkewPpm Rx clock error against the Tx clock in ppm, positive for a
+ *      faster Rx clock
+ * @param jitterPermille Maximum Tx edge delay in 1/1000 bit, at most 500
+ * @param noise Chance that an Rx sample is flipped, in 1/65536
+ * @param seed Random seed, must not be 0
+ * @return Pointer to the same piu_SimUARTWire struct passed in
+ */
+piu_SimUARTWire* piu_SimUARTWire_construct(piu_SimUARTWire* wire,
+                                           piu_SimUART* tx,
+                                           piu_SimUART* rx,
+                                           int32_t rxSkewPpm,
+                                           uint16_t jitterPermille,
+                                           uint16_t noise,
+                                           uint32_t seed);
+
+/**
+ * @brief Advance the simulation
+ * @param wire Pointer to a piu_SimUARTWire struct
+ * @param bits Number of Tx bit times to run
+ */
+void piu_SimUARTWire_run(piu_SimUARTWire* wire, uint32_t bits);
+
+/**
+ * @brief Get the number of Rx samples taken so far
+ * @param wire Pointer to a piu_SimUARTWire struct
+ * @return Number of samples
+ */
+uint64_t piu_SimUARTWire_getSamples(const piu_SimUARTWire* wire);
+/**
+ * @brief Get the number of Rx samples flipped by noise so far
+ * @param wire Pointer to a piu_SimUARTWire struct
+ * @return Number of flipped samples
+ */
+uint64_t piu_SimUARTWire_getFlips(const piu_SimUARTWire* wire);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif    // PIU_SIM_UART_WIRE_H
@@ -0,0 +1,195 @@
+//
+// Created by YthanZhang on 2026/10/19.
+//
+/*******************************************************************************
+ * Copyright 2021 Ythan(Ethan) Zhang
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************
+ * This software component is licensed by Ythan Zhang under the
+ *                           BSD-2-Clause license.
+ * You may not use this file except in compliance with the license.
+ * You may obtain a copy of the License at: opensource.org/licenses/BSD-2-Clause
+ ******************************************************************************/
+
+
+#include "piu_soft_pwm.h"
+
+
+// Counter never reaches this value, since counter < period <= UINT16_MAX
+#define EDGE_NEVER UINT16_MAX
+
+// Keep schedule writes from being reordered after the pending flag is set
+#if defined(__GNUC__)
+#define COMPILER_BARRIER() __asm__ volatile("" ::: "memory")
+#else
+#define COMPILER_BARRIER()
+#endif
+
+
+static void buildSchedule(const piu_SoftPWM* softPWM,
+                          piu_SoftPWMSchedule* schedule)
+{
+    uint8_t edgeCount = 0;
+
+    schedule->startMask = 0;
+    for (uint8_t ch = 0; ch < softPWM->channelCount; ++ch)
+    {
+        const uint16_t duty = softPWM->duty[ch];
+        const uint32_t bit  = (uint32_t)1 << ch;
+
+        if (duty == 0)
+        {
+            continue;
+        }
+        schedule->startMask |= bit;
+        if (duty >= softPWM->period)    // always high, no falling edge
+        {
+            continue;
+        }
+
+        // insertion into the sorted edge list, merging equal duty values
+        uint8_t i = 0;
+        while (i < edgeCount && schedule->edges[i].tick < duty) { ++i; }
+
+        if (i < edgeCount && schedule->edges[i].tick == duty)
+        {
+            schedule->edges[i].mask |= bit;
+            continue;
+        }
+
+        for (uint8_t j = edgeCount; j > i; --j)
+        {
+            schedule->edges[j] = schedule->edges[j - 1];
+        }
+        schedule->edges[i].tick = duty;
+        schedule->edges[i].mask = bit;
+        ++edgeCount;
+    }
+
+    schedule->edges[edgeCount].tick = EDGE_NEVER;
+    schedule->edges[edgeCount].mask = 0;
+}
+
+
+piu_SoftPWM* piu_SoftPWM_construct(piu_SoftPWM* softPWM,
+                                   uint16_t period,
+                                   uint8_t channelCount)
+{
+    softPWM->period       = period == 0 ? 1 : period;
+    softPWM->channelCount = channelCount > PIU_SOFT_PWM_CHANNEL_MAX
+                                ? PIU_SOFT_PWM_CHANNEL_MAX
+                                : channelCount;
+
+    for (uint8_t ch = 0; ch < PIU_SOFT_PWM_CHANNEL_MAX; ++ch)
+    {
+        softPWM->duty[ch] = 0;
+    }
+
+    buildSchedule(softPWM, &softPWM->schedule[0]);
+    buildSchedule(softPWM, &softPWM->schedule[1]);
+    softPWM->activeSchedule = 0;
+    softPWM->flag_pending   = false;
+
+    softPWM->counter  = 0;
+    softPWM->nextEdge = softPWM->schedule[0].edges;
+    softPWM->output   = 0;
+
+    return softPWM;
+}
+
+
+uint32_t piu_SoftPWM_tick(piu_SoftPWM* softPWM)
+{
+    if (softPWM->counter == 0)    // period boundary
+    {
+        if (softPWM->flag_pending)
+        {
+            softPWM->activeSchedule ^= 1;
+            softPWM->flag_pending = false;
+        }
+
+        const piu_SoftPWMSchedule* schedule =
+            &softPWM->schedule[softPWM->activeSchedule];
+        softPWM->output   = schedule->startMask;
+        softPWM->nextEdge = schedule->edges;
+    }
+
+    if (softPWM->counter == softPWM->nextEdge->tick)
+    {
+        softPWM->output &= ~softPWM->nextEdge->mask;
+        ++(softPWM->nextEdge);
+    }
+
+    if (++(softPWM->counter) >= softPWM->period)
+    {
+        softPWM->counter = 0;
+    }
+
+    return softPWM->output;
+}
+
+
+uint16_t piu_SoftPWM_setDuty(piu_SoftPWM* softPWM,
+                             uint8_t channel,
+                             uint16_t duty)
+{
+    if (channel >= softPWM->channelCount)
+    {
+        return 0;
+    }
+    if (duty > softPWM->period)
+    {
+        duty = softPWM->period;
+    }
+    return softPWM->duty[channel] = duty;
+}
+
+uint16_t piu_SoftPWM_getDuty(const piu_SoftPWM* softPWM, uint8_t channel)
+{
+    if (channel >= softPWM->channelCount)
+    {
+        return 0;
+    }
+    return softPWM->duty[channel];
+}
+
+
+bool piu_SoftPWM_commit(piu_SoftPWM* softPWM)
+{
+    if (softPWM->flag_pending)
+    {
+        return false;
+    }
+
+    buildSchedule(softPWM,
+                  &softPWM->schedule[softPWM->activeSchedule ^ 1]);
+
+    COMPILER_BARRIER();
+    softPWM->flag_pending = true;
+    return true;
+}
+
+bool piu_SoftPWM_getCommitPending(const piu_SoftPWM* softPWM)
+{
+    return softPWM->flag_pending;
+}
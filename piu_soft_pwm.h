@@ -0,0 +1,183 @@
+//
+// Created by YthanZhang on 2026/10/19.
+//
+/*******************************************************************************
+ * Copyright 2021 Ythan(Ethan) Zhang
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************
+ * This software component is licensed by Ythan Zhang under the
+ *                           BSD-2-Clause license.
+ * You may not use this file except in compliance with the license.
+ * You may obtain a copy of the License at: opensource.org/licenses/BSD-2-Clause
+ ******************************************************************************/
+
+
+/*******************************************************************************
+ * @file piu_soft_pwm.h
+ *
+ * Bank of software PWM channels sharing one tick and one GPIO port word. @n
+ *
+ * The duty values of all channels are compiled into an edge schedule: the
+ *  channels that start high at the beginning of a period, followed by the
+ *  falling edges sorted by time, channels with the same duty share an edge.
+ *  <b>piu_SoftPWM_tick</b> only compares the counter against the next edge, so
+ *  the per tick cost does not depend on the number of channels. @n
+ *
+ * Duty updates are double buffered: <b>piu_SoftPWM_setDuty</b> stages new
+ *  values, <b>piu_SoftPWM_commit</b> builds the schedule into the inactive
+ *  buffer, and the tick swaps buffers at the next period boundary, so a
+ *  period is never output with half old and half new duty values. @n
+ *
+ * @example 24 fan/LED channels on one 32 bits port, 100 steps resolution
+ * @code
+ *  piu_SoftPWM pwm;
+ *  piu_SoftPWM_construct(&pwm, 100, 24);
+ *
+ *  piu_SoftPWM_setDuty(&pwm, 0, 25);
+ *  piu_SoftPWM_setDuty(&pwm, 1, 75);
+ *  piu_SoftPWM_commit(&pwm);
+ *
+ *  void TIMER_IT_HANDLE(void) { GPIOA->ODR = piu_SoftPWM_tick(&pwm); }
+ * @endcode
+ */
+
+
+#ifndef PIU_SOFT_PWM_H
+#define PIU_SOFT_PWM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+#include <stdbool.h>
+#include <stdint.h>
+
+
+// Maximum number of channels in a bank, one bit of the port word per channel
+#ifndef PIU_SOFT_PWM_CHANNEL_MAX
+#define PIU_SOFT_PWM_CHANNEL_MAX 32
+#endif
+
+#if PIU_SOFT_PWM_CHANNEL_MAX > 32
+#error "PIU_SOFT_PWM_CHANNEL_MAX must not exceed 32"
+#endif
+
+
+typedef struct piu_struct_SoftPWMEdge
+{
+    uint16_t tick;    // Counter value on which the channels go low
+    uint32_t mask;    // Channels going low on this edge
+} piu_SoftPWMEdge;
+
+typedef struct piu_struct_SoftPWMSchedule
+{
+    uint32_t startMask;    // Channels high at the start of a period
+    // Sorted falling edges, terminated by an edge that never matches
+    piu_SoftPWMEdge edges[PIU_SOFT_PWM_CHANNEL_MAX + 1];
+} piu_SoftPWMSchedule;
+
+
+/**
+ * @warning All data contained in this struct should be considered private and
+ *      should only be accessed with functions starting with
+ *      <b>piu_SoftPWM_</b>
+ */
+typedef struct piu_struct_SoftPWM
+{
+    uint16_t period;
+    uint8_t channelCount;
+
+    uint16_t duty[PIU_SOFT_PWM_CHANNEL_MAX];    // Staged duty values
+
+    piu_SoftPWMSchedule schedule[2];
+    uint8_t activeSchedule;
+    volatile bool flag_pending;    // Inactive schedule waits for a boundary
+
+    uint16_t counter;
+    const piu_SoftPWMEdge* nextEdge;
+    uint32_t output;
+} piu_SoftPWM;
+
+
+/**
+ * @brief Use this function to initialize a piu_SoftPWM struct
+ * @note All channels start with a duty of 0
+ * @param softPWM Pointer to an uninitialized piu_SoftPWM struct
+ * @param period Number of ticks in one PWM period, must not be 0
+ * @param channelCount Number of channels, channel n is bit n of the port word
+ * @return Pointer to the same piu_SoftPWM struct passed in
+ */
+piu_SoftPWM* piu_SoftPWM_construct(piu_SoftPWM* softPWM,
+                                   uint16_t period,
+                                   uint8_t channelCount);
+
+/**
+ * @brief Call this function at a constant interval, e.g. in a timer interrupt
+ * @param softPWM Pointer to a piu_SoftPWM struct
+ * @return The port word for this tick, bit n is the output of channel n
+ */
+uint32_t piu_SoftPWM_tick(piu_SoftPWM* softPWM);
+
+/**
+ * @brief Stage a new duty value for a channel
+ * @note Takes effect after piu_SoftPWM_commit, at the next period boundary
+ * @param softPWM Pointer to a piu_SoftPWM struct
+ * @param channel Channel index
+ * @param duty Number of ticks the channel is high per period, values greater
+ *      than the period are clamped to the period
+ * @return The staged duty value
+ */
+uint16_t piu_SoftPWM_setDuty(piu_SoftPWM* softPWM,
+                             uint8_t channel,
+                             uint16_t duty);
+/**
+ * @brief Get the staged duty value of a channel
+ * @param softPWM Pointer to a piu_SoftPWM struct
+ * @param channel Channel index
+ * @return The staged duty value
+ */
+uint16_t piu_SoftPWM_getDuty(const piu_SoftPWM* softPWM, uint8_t channel);
+
+/**
+ * @brief Build the edge schedule from the staged duty values, the tick
+ *      function switches to it at the next period boundary
+ * @param softPWM Pointer to a piu_SoftPWM struct
+ * @return <b>true</b> if the schedule is committed, <b>false</b> if the
+ *      previous commit has not been applied yet, try again later
+ */
+bool piu_SoftPWM_commit(piu_SoftPWM* softPWM);
+
+/**
+ * @brief Get if a committed schedule is still waiting for a period boundary
+ * @param softPWM Pointer to a piu_SoftPWM struct
+ * @return <b>true</b> if a commit is pending, <b>false</b> otherwise
+ */
+bool piu_SoftPWM_getCommitPending(const piu_SoftPWM* softPWM);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif    // PIU_SOFT_PWM_H
@@ -0,0 +1,81 @@
+//
+// Created by YthanZhang on 2026/10/19.
+//
+/*******************************************************************************
+ * Copyright 2021 Ythan(Ethan) Zhang
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************
+ * This software component is licensed by Ythan Zhang under the
+ *                           BSD-2-Clause license.
+ * You may not use this file except in compliance with the license.
+ * You may obtain a copy of the License at: opensource.org/licenses/BSD-2-Clause
+ ******************************************************************************/
+
+
+#if defined(__GNUC__) && defined(__ELF__)
+
+
+#include "piu_tick_registry.h"
+
+
+// Provided by the linker, weak so an empty section links to an empty range
+extern piu_VTimer __start_piu_vtimer[] __attribute__((weak));
+extern piu_VTimer __stop_piu_vtimer[] __attribute__((weak));
+
+extern piu_Button __start_piu_button[] __attribute__((weak));
+extern piu_Button __stop_piu_button[] __attribute__((weak));
+
+extern const piu_TickDesc __start_piu_tick[] __attribute__((weak));
+extern const piu_TickDesc __stop_piu_tick[] __attribute__((weak));
+
+
+void piu_tickAll(void)
+{
+    for (piu_VTimer* vTimer = __start_piu_vtimer; vTimer < __stop_piu_vtimer;
+         ++vTimer)
+    {
+        piu_VTimer_tick(vTimer);
+    }
+
+    for (piu_Button* button = __start_piu_button; button < __stop_piu_button;
+         ++button)
+    {
+        piu_Button_tick(button);
+    }
+
+    for (const piu_TickDesc* desc = __start_piu_tick; desc < __stop_piu_tick;
+         ++desc)
+    {
+        desc->tickFunc(desc->object);
+    }
+}
+
+uint16_t piu_tickRegistry_count(void)
+{
+    return (uint16_t)((__stop_piu_vtimer - __start_piu_vtimer) +
+                      (__stop_piu_button - __start_piu_button) +
+                      (__stop_piu_tick - __start_piu_tick));
+}
+
+
+#endif
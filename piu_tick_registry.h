@@ -0,0 +1,157 @@
+//
+// Created by YthanZhang on 2026/10/19.
+//
+/*******************************************************************************
+ * Copyright 2021 Ythan(Ethan) Zhang
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************
+ * This software component is licensed by Ythan Zhang under the
+ *                           BSD-2-Clause license.
+ * You may not use this file except in compliance with the license.
+ * You may obtain a copy of the License at: opensource.org/licenses/BSD-2-Clause
+ ******************************************************************************/
+
+
+/*******************************************************************************
+ * @file piu_tick_registry.h
+ *
+ * Link time registration of objects that need to be ticked. @n
+ *
+ * The registration macros define the object inside a dedicated linker
+ *  section, one section per object type. The linker then places all objects
+ *  of a type next to each other, and GNU ld provides the
+ *  <b>__start_SECTION</b>/<b>__stop_SECTION</b> symbols bounding them. One
+ *  call to <b>piu_tickAll</b> walks these arrays in memory order: @n
+ *  - <b>piu_vtimer</b> section, piu_VTimer objects, ticked with
+ *  piu_VTimer_tick @n
+ *  - <b>piu_button</b> section, piu_Button objects, ticked with
+ *  piu_Button_tick @n
+ *  - <b>piu_tick</b> section, piu_TickDesc descriptors for anything else,
+ *  calls @p tickFunc with @p object @n
+ *
+ * No construct call, no runtime list and no registration code is needed, the
+ *  set of ticked objects is fixed at link time. @n
+ *
+ * @note Requires a GNU compatible compiler and an ELF linker providing the
+ *  start/stop symbols (GNU ld, gold, lld). When linking with
+ *  <b>--gc-sections</b> and <b>-z start-stop-gc</b>, the sections must be
+ *  kept with <b>KEEP()</b> in the linker script.
+ * @note Objects registered inside a static library are only linked in if
+ *  something else in their translation unit is referenced.
+ *
+ * @example
+ * @code
+ *  static PIU_VTIMER_REGISTER(blinkTimer, 499, piu_VTMode_Continuous, blink);
+ *  static PIU_BUTTON_REGISTER(userButton, 5);
+ *  PIU_TICK_REGISTER(watchdogTick, feedWatchdog, NULL);
+ *
+ *  void SysTick_Handler(void) { piu_tickAll(); }
+ * @endcode
+ */
+
+
+#ifndef PIU_TICK_REGISTRY_H
+#define PIU_TICK_REGISTRY_H
+
+#if !defined(__GNUC__) || !defined(__ELF__)
+#error "piu_tick_registry.h requires a GNU compatible compiler targeting ELF"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+#include "piu_button.h"
+#include "piu_vtimer.h"
+
+
+typedef struct piu_struct_TickDesc
+{
+    void (*tickFunc)(void* object);
+    void* object;
+} piu_TickDesc;
+
+
+// The explicit alignment keeps the compiler from over aligning individual
+// objects, which would break the array stride inside the section
+#define PIU_TICK_SECTION_ATTR(SECTION, TYPE)                                   \
+    __attribute__((section(#SECTION), used, aligned(__alignof__(TYPE))))
+
+
+/**
+ * @brief Define a piu_VTimer and register it to piu_tickAll
+ * @note Can be prefixed with @p static, the timer is otherwise an ordinary
+ *      piu_VTimer created with PIU_VTIMER_MAKE
+ * @param NAME Name of the piu_VTimer variable
+ * @param COUNTER_RELOAD_VALUE See PIU_VTIMER_MAKE
+ * @param TIMER_MODE See PIU_VTIMER_MAKE
+ * @param CALLBACK_FUNC See PIU_VTIMER_MAKE
+ */
+#define PIU_VTIMER_REGISTER(                                                   \
+    NAME, COUNTER_RELOAD_VALUE, TIMER_MODE, CALLBACK_FUNC)                     \
+    piu_VTimer NAME PIU_TICK_SECTION_ATTR(piu_vtimer, piu_VTimer) =            \
+        PIU_VTIMER_MAKE(COUNTER_RELOAD_VALUE, TIMER_MODE, CALLBACK_FUNC)
+
+/**
+ * @brief Define a piu_Button and register it to piu_tickAll
+ * @note Can be prefixed with @p static, the button is otherwise an ordinary
+ *      piu_Button created with PIU_BUTTON_MAKE
+ * @param NAME Name of the piu_Button variable
+ * @param STABLE_THRESHOLD See PIU_BUTTON_MAKE
+ */
+#define PIU_BUTTON_REGISTER(NAME, STABLE_THRESHOLD)                            \
+    piu_Button NAME PIU_TICK_SECTION_ATTR(piu_button, piu_Button) =            \
+        PIU_BUTTON_MAKE(STABLE_THRESHOLD)
+
+/**
+ * @brief Register any tick function to piu_tickAll
+ * @param NAME Name of the (static) descriptor variable
+ * @param TICK_FUNC Function taking one <b>void*</b> argument
+ * @param OBJECT Pointer passed to @p TICK_FUNC, may be @p NULL
+ */
+#define PIU_TICK_REGISTER(NAME, TICK_FUNC, OBJECT)                             \
+    static const piu_TickDesc NAME PIU_TICK_SECTION_ATTR(piu_tick,             \
+                                                         piu_TickDesc) = {     \
+        (TICK_FUNC), (OBJECT)}
+
+
+/**
+ * @brief Tick every registered piu_VTimer, piu_Button and tick descriptor
+ * @note Should be called at a constant interval, same as piu_VTimer_tick and
+ *      piu_Button_tick
+ */
+void piu_tickAll(void);
+
+/**
+ * @brief Get the number of registered objects
+ * @return Number of registered piu_VTimer, piu_Button and descriptors combined
+ */
+uint16_t piu_tickRegistry_count(void);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif    // PIU_TICK_REGISTRY_H
@@ -35,122 +35,6 @@
 #include "piu_vtimer.h"
 
 
-piu_VTimer* piu_VTimer_construct(piu_VTimer* vTimer,
-                                 uint16_t counterReloadValue,
-                                 piu_VTMode timerMode,
-                                 void (*callbackFunc)(void))
-{
-    vTimer->counterReloadValue = counterReloadValue;
-
-    vTimer->timerMode = timerMode;
-
-    vTimer->callback = callbackFunc;
-
-    vTimer->counter = 0;
-
-    vTimer->flag_overflow      = false;
-    vTimer->flag_overOverflow  = false;
-    vTimer->flag_counterActive = false;
-
-    return vTimer;
-}
-
-
-void piu_VTimer_tick(piu_VTimer* vTimer)
-{
-    // only tick if counter is active
-    if (!vTimer->flag_counterActive)
-        ;
-    else if (vTimer->counter >= vTimer->counterReloadValue)
-    {
-        if (vTimer->flag_overflow)
-        {
-            vTimer->flag_overOverflow = true;
-        }
-        vTimer->flag_overflow = true;
-
-        vTimer->flag_counterActive = (vTimer->timerMode != piu_VTMode_OneShot);
-        vTimer->counter            = 0;
-
-        if (vTimer->callback != NULL)
-        {
-            vTimer->callback();
-        }
-    }
-    else
-    {
-        ++(vTimer->counter);
-    }
-}
-
-
-uint16_t piu_VTimer_setCounterReloadValue(piu_VTimer* vTimer,
-                                          uint16_t counterReloadValue)
-{
-    return vTimer->counterReloadValue = counterReloadValue;
-}
-
-piu_VTMode piu_VTimer_setTimerMode(piu_VTimer* vTimer, piu_VTMode timerMode)
-{
-    return vTimer->timerMode = timerMode;
-}
-
-void piu_VTimer_setCallback(piu_VTimer* vTimer, void (*callbackFunc)(void))
-{
-    if (!vTimer->flag_counterActive)
-    {
-        vTimer->callback = callbackFunc;
-    }
-}
-
-
-uint16_t piu_VTimer_startCounter(piu_VTimer* vTimer)
-{
-    uint16_t counter           = vTimer->counter;
-    vTimer->flag_counterActive = true;
-    return counter;
-}
-
-uint16_t piu_VTimer_stopCounter(piu_VTimer* vTimer)
-{
-    vTimer->flag_counterActive = false;
-    return vTimer->counter;
-}
-
-uint16_t piu_VTimer_resetCounter(piu_VTimer* vTimer)
-{
-    return vTimer->counter = 0;
-}
-
-uint16_t piu_VTimer_getCounter(piu_VTimer* vTimer) { return vTimer->counter; }
-
-uint16_t piu_VTimer_getCounterReloadValue(piu_VTimer* vTimer)
-{
-    return vTimer->counterReloadValue;
-}
-
-
-bool piu_VTimer_getOverflow(piu_VTimer* vTimer)
-{
-    bool flag             = vTimer->flag_overflow;
-    vTimer->flag_overflow = false;
-    return flag;
-}
-
-bool piu_VTimer_getOverOverflow(piu_VTimer* vTimer)
-{
-    return vTimer->flag_overOverflow;
-}
-
-bool piu_VTimer_getCounterActive(piu_VTimer* vTimer)
-{
-    return vTimer->flag_counterActive;
-}
-
-
-bool piu_VTimer_clearOverOverflow(piu_VTimer* vTimer)
-{
-    bool flag                 = vTimer->flag_overOverflow;
-    vTimer->flag_overOverflow = false;
-    return flag;
-}
+// The implementation is shared with the other counter widths, see
+// piu_vtimer_template.h
+PIU_VTIMER_DEFINE(piu_VTimer, uint16_t)
@@ -44,12 +44,7 @@ extern "C" {
 #include <stddef.h>
 #include <stdint.h>
 
-
-typedef enum piu_enum_VTMode
-{
-    piu_VTMode_OneShot,
-    piu_VTMode_Continuous,
-} piu_VTMode;
+#include "piu_vtimer_template.h"
 
 
 typedef enum piu_enum_VTCDir
@@ -59,20 +54,7 @@ typedef enum piu_enum_VTCDir
 } piu_VTCDir;
 
 
-typedef struct piu_struct_VTimer
-{
-    uint16_t counterReloadValue;
-
-    piu_VTMode timerMode;
-
-    void (*callback)(void);
-
-    uint16_t counter;
-
-    bool flag_overflow;
-    bool flag_overOverflow;
-    bool flag_counterActive;
-} piu_VTimer;
+PIU_VTIMER_DECLARE_STRUCT(piu_struct_VTimer, piu_VTimer, uint16_t)
 
 
 /**
@@ -90,7 +72,7 @@ typedef struct piu_struct_VTimer
  */
 #define PIU_VTIMER_MAKE(COUNTER_RELOAD_VALUE, TIMER_MODE, CALLBACK_FUNC)       \
     {                                                                          \
-        (COUNTER_RELOAD_VALUE), (TIMER_MODE), (CALLBACK_FUNC), 0, false,       \
+        (CALLBACK_FUNC), (COUNTER_RELOAD_VALUE), 0, (TIMER_MODE), false,       \
             false, false,                                                      \
     }
 
@@ -0,0 +1,265 @@
+//
+// Created by YthanZhang on 2026/10/19.
+//
+/*******************************************************************************
+ * Copyright 2021 Ythan(Ethan) Zhang
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************
+ * This software component is licensed by Ythan Zhang under the
+ *                           BSD-2-Clause license.
+ * You may not use this file except in compliance with the license.
+ * You may obtain a copy of the License at: opensource.org/licenses/BSD-2-Clause
+ ******************************************************************************/
+
+
+#include "piu_vtimer_scheduler.h"
+
+#include <stddef.h>
+
+
+// Wrap around safe "a is before b"
+static bool isBefore(uint32_t a, uint32_t b) { return (int32_t)(a - b) < 0; }
+
+static uint32_t timerPeriod(const piu_VTimer* vTimer)
+{
+    return (uint32_t)vTimer->counterReloadValue + 1;
+}
+
+
+static piu_VTSchedEntry* findEntry(piu_VTScheduler* scheduler,
+                                   const piu_VTimer* vTimer)
+{
+    for (uint16_t i = 0; i < scheduler->entryCount; ++i)
+    {
+        if (scheduler->entries[i].vTimer == vTimer)
+        {
+            return &scheduler->entries[i];
+        }
+    }
+    return NULL;
+}
+
+static void updateNextWake(piu_VTScheduler* scheduler)
+{
+    scheduler->flag_idle = true;
+
+    for (uint16_t i = 0; i < scheduler->entryCount; ++i)
+    {
+        piu_VTSchedEntry* entry = &scheduler->entries[i];
+        if (!entry->flag_scheduled)
+        {
+            continue;
+        }
+
+        const uint32_t latest = entry->deadline + entry->slack;
+        if (scheduler->flag_idle || isBefore(latest, scheduler->nextWake))
+        {
+            scheduler->nextWake  = latest;
+            scheduler->flag_idle = false;
+        }
+    }
+}
+
+static void scheduleEntry(piu_VTScheduler* scheduler, piu_VTSchedEntry* entry)
+{
+    entry->deadline       = scheduler->now + timerPeriod(entry->vTimer);
+    entry->flag_scheduled = true;
+    entry->flag_expired   = false;
+
+    const uint32_t latest = entry->deadline + entry->slack;
+    if (scheduler->flag_idle || isBefore(latest, scheduler->nextWake))
+    {
+        scheduler->nextWake  = latest;
+        scheduler->flag_idle = false;
+    }
+}
+
+static void wakeUp(piu_VTScheduler* scheduler)
+{
+    ++(scheduler->wakeCount);
+
+    // Expire every timer whose window has opened, update the timer states
+    // first so callbacks see a consistent batch
+    for (uint16_t i = 0; i < scheduler->entryCount; ++i)
+    {
+        piu_VTSchedEntry* entry = &scheduler->entries[i];
+        piu_VTimer* vTimer      = entry->vTimer;
+
+        if (!entry->flag_scheduled)
+        {
+            continue;
+        }
+        if (!vTimer->flag_counterActive)    // stopped outside the scheduler
+        {
+            entry->flag_scheduled = false;
+            continue;
+        }
+        if (isBefore(scheduler->now, entry->deadline))
+        {
+            continue;
+        }
+
+        if (vTimer->flag_overflow)
+        {
+            vTimer->flag_overOverflow = true;
+        }
+        vTimer->flag_overflow      = true;
+        vTimer->flag_counterActive = (vTimer->timerMode != piu_VTMode_OneShot);
+        vTimer->counter            = 0;
+
+        entry->flag_expired   = true;
+        entry->flag_scheduled = vTimer->flag_counterActive;
+
+        // Keep the nominal period, but never schedule into the past
+        entry->deadline += timerPeriod(vTimer);
+        if (!isBefore(scheduler->now, entry->deadline))
+        {
+            entry->deadline = scheduler->now + 1;
+        }
+    }
+
+    // Dispatch the batch
+    for (uint16_t i = 0; i < scheduler->entryCount; ++i)
+    {
+        piu_VTSchedEntry* entry = &scheduler->entries[i];
+        if (entry->flag_expired)
+        {
+            entry->flag_expired = false;
+            if (entry->vTimer->callback != NULL)
+            {
+                entry->vTimer->callback();
+            }
+        }
+    }
+
+    updateNextWake(scheduler);
+}
+
+
+piu_VTScheduler* piu_VTScheduler_construct(piu_VTScheduler* scheduler,
+                                           piu_VTSchedEntry* entries,
+                                           uint16_t entryCount)
+{
+    scheduler->entries    = entries;
+    scheduler->entryCount = entryCount;
+
+    scheduler->now       = 0;
+    scheduler->nextWake  = 0;
+    scheduler->wakeCount = 0;
+    scheduler->flag_idle = true;
+
+    for (uint16_t i = 0; i < entryCount; ++i)
+    {
+        entries[i].flag_scheduled = false;
+        entries[i].flag_expired   = false;
+        if (entries[i].vTimer->flag_counterActive)
+        {
+            scheduleEntry(scheduler, &entries[i]);
+        }
+    }
+
+    return scheduler;
+}
+
+
+void piu_VTScheduler_tick(piu_VTScheduler* scheduler)
+{
+    ++(scheduler->now);
+    if (scheduler->now != scheduler->nextWake || scheduler->flag_idle)
+    {
+        return;
+    }
+
+    wakeUp(scheduler);
+}
+
+
+uint32_t piu_VTScheduler_ticksToWake(const piu_VTScheduler* scheduler)
+{
+    if (scheduler->flag_idle)
+    {
+        return UINT32_MAX;
+    }
+    return scheduler->nextWake - scheduler->now;
+}
+
+uint32_t piu_VTScheduler_advance(piu_VTScheduler* scheduler, uint32_t ticks)
+{
+    const uint32_t toWake = piu_VTScheduler_ticksToWake(scheduler);
+    if (ticks > toWake)
+    {
+        ticks = toWake;
+    }
+    if (ticks == 0)
+    {
+        return 0;
+    }
+
+    scheduler->now += ticks - 1;
+    piu_VTScheduler_tick(scheduler);
+
+    return ticks;
+}
+
+
+bool piu_VTScheduler_startTimer(piu_VTScheduler* scheduler, piu_VTimer* vTimer)
+{
+    piu_VTSchedEntry* entry = findEntry(scheduler, vTimer);
+    if (entry == NULL)
+    {
+        return false;
+    }
+
+    vTimer->counter            = 0;
+    vTimer->flag_counterActive = true;
+
+    if (entry->flag_scheduled)
+    {
+        entry->flag_scheduled = false;
+        updateNextWake(scheduler);
+    }
+    scheduleEntry(scheduler, entry);
+
+    return true;
+}
+
+bool piu_VTScheduler_stopTimer(piu_VTScheduler* scheduler, piu_VTimer* vTimer)
+{
+    piu_VTSchedEntry* entry = findEntry(scheduler, vTimer);
+    if (entry == NULL)
+    {
+        return false;
+    }
+
+    vTimer->flag_counterActive = false;
+    entry->flag_scheduled      = false;
+    updateNextWake(scheduler);
+
+    return true;
+}
+
+
+uint32_t piu_VTScheduler_getWakeCount(const piu_VTScheduler* scheduler)
+{
+    return scheduler->wakeCount;
+}
@@ -0,0 +1,213 @@
+//
+// Created by YthanZhang on 2026/10/19.
+//
+/*******************************************************************************
+ * Copyright 2021 Ythan(Ethan) Zhang
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************
+ * This software component is licensed by Ythan Zhang under the
+ *                           BSD-2-Clause license.
+ * You may not use this file except in compliance with the license.
+ * You may obtain a copy of the License at: opensource.org/licenses/BSD-2-Clause
+ ******************************************************************************/
+
+
+/*******************************************************************************
+ * @file piu_vtimer_scheduler.h
+ *
+ * Scheduler that drives a set of <b>piu_VTimer</b> and coalesces expiries
+ * that are allowed to be late. @n
+ *
+ * Each managed timer has a @p slack, the number of ticks its expiry may be
+ *  delayed. A timer started at tick @p t with counter reload value @p r should
+ *  expire at tick <b>t + r + 1</b>, same as with <b>piu_VTimer_tick</b>, and
+ *  must expire no later than <b>t + r + 1 + slack</b>. @n
+ *
+ * The scheduler only wakes up at the earliest "must expire" tick of all
+ *  timers, and on that wake up expires every timer whose window has already
+ *  opened. Timers with overlapping windows therefore expire on the same tick,
+ *  their callbacks are dispatched back to back as one batch. @n
+ *
+ * <b>piu_VTScheduler_tick</b> is a single compare on ticks without a wake up.
+ *  For tickless low power operation, sleep for
+ *  <b>piu_VTScheduler_ticksToWake</b> ticks and then call
+ *  <b>piu_VTScheduler_advance</b>. @n
+ *
+ * On expiry the managed piu_VTimer behaves as if its overflow happened in
+ *  <b>piu_VTimer_tick</b>: overflow flags are set, one shot timers become
+ *  inactive and the callback is called. @n
+ *
+ * @note Managed timers must not be passed to piu_VTimer_tick, and their
+ *  counter value is not maintained. Start them with
+ *  <b>piu_VTScheduler_startTimer</b>, stopping with piu_VTimer_stopCounter or
+ *  <b>piu_VTScheduler_stopTimer</b> both work.
+ *
+ * @example
+ * @code
+ *  static piu_VTimer ledTimer    = PIU_VTIMER_MAKE(99, piu_VTMode_Continuous,
+ *                                                  blinkLed);
+ *  static piu_VTimer sensorTimer = PIU_VTIMER_MAKE(119, piu_VTMode_Continuous,
+ *                                                  pollSensor);
+ *
+ *  static piu_VTSchedEntry entries[] = {
+ *      PIU_VTSCHED_ENTRY(&ledTimer, 20),
+ *      PIU_VTSCHED_ENTRY(&sensorTimer, 30),
+ *  };
+ *  piu_VTScheduler scheduler;
+ *  piu_VTScheduler_construct(&scheduler, entries, 2);
+ *
+ *  piu_VTScheduler_startTimer(&scheduler, &ledTimer);
+ *  piu_VTScheduler_startTimer(&scheduler, &sensorTimer);
+ *
+ *  // in the tick interrupt
+ *  piu_VTScheduler_tick(&scheduler);
+ * @endcode
+ */
+
+
+#ifndef PIU_VTIMER_SCHEDULER_H
+#define PIU_VTIMER_SCHEDULER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "piu_vtimer.h"
+
+
+/**
+ * @warning All data contained in this struct should be considered private and
+ *      should only be accessed with functions starting with
+ *      <b>piu_VTScheduler_</b>
+ */
+typedef struct piu_struct_VTSchedEntry
+{
+    piu_VTimer* vTimer;
+    uint16_t slack;
+
+    uint32_t deadline;    // Earliest tick the timer may expire on
+
+    bool flag_scheduled;
+    bool flag_expired;
+} piu_VTSchedEntry;
+
+
+/**
+ * @brief Use this macro to create a piu_VTSchedEntry
+ * @param VTIMER Pointer to the piu_VTimer managed by this entry
+ * @param SLACK How many ticks the expiry of this timer may be delayed
+ */
+#define PIU_VTSCHED_ENTRY(VTIMER, SLACK)                                       \
+    {                                                                          \
+        (VTIMER), (SLACK), 0, false, false                                     \
+    }
+
+
+/**
+ * @warning All data contained in this struct should be considered private and
+ *      should only be accessed with functions starting with
+ *      <b>piu_VTScheduler_</b>
+ */
+typedef struct piu_struct_VTScheduler
+{
+    piu_VTSchedEntry* entries;
+    uint16_t entryCount;
+
+    uint32_t now;
+    uint32_t nextWake;
+    uint32_t wakeCount;
+
+    bool flag_idle;    // No timer scheduled
+} piu_VTScheduler;
+
+
+/**
+ * @brief Use this function to initialize a piu_VTScheduler struct
+ * @note Timers that are already active are scheduled as if started now
+ * @param scheduler Pointer to an uninitialized piu_VTScheduler struct
+ * @param entries Array of entries created with PIU_VTSCHED_ENTRY, the array
+ *      must stay valid while the scheduler is used
+ * @param entryCount Number of elements in @p entries
+ * @return Pointer to the same piu_VTScheduler struct passed in
+ */
+piu_VTScheduler* piu_VTScheduler_construct(piu_VTScheduler* scheduler,
+                                           piu_VTSchedEntry* entries,
+                                           uint16_t entryCount);
+
+/**
+ * @brief Should call this function at the tick interval the managed timers
+ *      are designed for
+ * @param scheduler Pointer to a piu_VTScheduler struct
+ */
+void piu_VTScheduler_tick(piu_VTScheduler* scheduler);
+
+/**
+ * @brief Get how many ticks until the next wake up
+ * @param scheduler Pointer to a piu_VTScheduler struct
+ * @return Ticks until the next wake up, @p UINT32_MAX if no timer is scheduled
+ */
+uint32_t piu_VTScheduler_ticksToWake(const piu_VTScheduler* scheduler);
+/**
+ * @brief Advance the scheduler by multiple ticks at once, e.g. after sleeping
+ * @note Advancing is capped at the next wake up, the return value tells how
+ *      many ticks were actually consumed
+ * @param scheduler Pointer to a piu_VTScheduler struct
+ * @param ticks Number of ticks elapsed
+ * @return Number of ticks consumed
+ */
+uint32_t piu_VTScheduler_advance(piu_VTScheduler* scheduler, uint32_t ticks);
+
+/**
+ * @brief Start a managed timer, the first expiry is counterReloadValue + 1
+ *      ticks from now
+ * @note Restarts the timer if it is already running
+ * @param scheduler Pointer to a piu_VTScheduler struct
+ * @param vTimer Pointer to a piu_VTimer managed by the scheduler
+ * @return @p false if @p vTimer is not managed by this scheduler
+ */
+bool piu_VTScheduler_startTimer(piu_VTScheduler* scheduler, piu_VTimer* vTimer);
+/**
+ * @brief Stop a managed timer
+ * @param scheduler Pointer to a piu_VTScheduler struct
+ * @param vTimer Pointer to a piu_VTimer managed by the scheduler
+ * @return @p false if @p vTimer is not managed by this scheduler
+ */
+bool piu_VTScheduler_stopTimer(piu_VTScheduler* scheduler, piu_VTimer* vTimer);
+
+/**
+ * @brief Get the number of wake ups so far, each wake up expires one batch
+ * @param scheduler Pointer to a piu_VTScheduler struct
+ * @return Number of wake ups
+ */
+uint32_t piu_VTScheduler_getWakeCount(const piu_VTScheduler* scheduler);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif    // PIU_VTIMER_SCHEDULER_H
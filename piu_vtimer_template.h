@@ -0,0 +1,230 @@
+//
+// Created by YthanZhang on 2026/10/19.
+//
+/*******************************************************************************
+ * Copyright 2021 Ythan(Ethan) Zhang
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************
+ * This software component is licensed by Ythan Zhang under the
+ *                           BSD-2-Clause license.
+ * You may not use this file except in compliance with the license.
+ * You may obtain a copy of the License at: opensource.org/licenses/BSD-2-Clause
+ ******************************************************************************/
+
+
+/*******************************************************************************
+ * @file piu_vtimer_template.h
+ *
+ * The single implementation of the virtual timer, written as macros so the
+ * same code can be stamped out for any unsigned counter type. @n
+ *
+ * <b>PIU_VTIMER_DECLARE(NAME, COUNTER_T)</b> declares the struct <b>NAME</b>
+ *  and all <b>NAME_xxx</b> functions, put it in a header @n
+ * <b>PIU_VTIMER_DEFINE(NAME, COUNTER_T)</b> defines the functions, put it in
+ *  exactly one translation unit @n
+ *
+ * The generated struct has the same member order as <b>piu_VTimer</b>, so
+ * <b>PIU_VTIMER_MAKE</b> also initializes every generated timer type. The
+ * generated functions behave exactly as documented in piu_vtimer.h.
+ *
+ * @note piu_vtimer.h and piu_vtimer_width.h already provide the 8, 16, 32 and
+ *  64 bits timers, only use these macros directly for other counter types.
+ */
+
+
+#ifndef PIU_VTIMER_TEMPLATE_H
+#define PIU_VTIMER_TEMPLATE_H
+
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+
+typedef enum piu_enum_VTMode
+{
+    piu_VTMode_OneShot,
+    piu_VTMode_Continuous,
+} piu_VTMode;
+
+
+// Member order keeps padding low: pointer, counters, then mode and flags in
+// the last bytes, so narrow counters give a smaller struct
+#define PIU_VTIMER_DECLARE_STRUCT(TAG, NAME, COUNTER_T)                        \
+    typedef struct TAG                                                         \
+    {                                                                          \
+        void (*callback)(void);                                                \
+                                                                               \
+        COUNTER_T counterReloadValue;                                          \
+        COUNTER_T counter;                                                     \
+                                                                               \
+        uint8_t timerMode; /* piu_VTMode */                                    \
+                                                                               \
+        bool flag_overflow : 1;                                                \
+        bool flag_overOverflow : 1;                                            \
+        bool flag_counterActive : 1;                                           \
+    } NAME;
+
+
+#define PIU_VTIMER_DECLARE(NAME, COUNTER_T)                                    \
+    PIU_VTIMER_DECLARE_STRUCT(NAME##_struct, NAME, COUNTER_T)                  \
+                                                                               \
+    NAME* NAME##_construct(NAME* vTimer,                                       \
+                           COUNTER_T counterReloadValue,                       \
+                           piu_VTMode timerMode,                               \
+                           void (*callbackFunc)(void));                        \
+    void NAME##_tick(NAME* vTimer);                                            \
+    COUNTER_T NAME##_setCounterReloadValue(NAME* vTimer,                       \
+                                           COUNTER_T counterReloadValue);      \
+    piu_VTMode NAME##_setTimerMode(NAME* vTimer, piu_VTMode timerMode);        \
+    void NAME##_setCallback(NAME* vTimer, void (*callbackFunc)(void));         \
+    COUNTER_T NAME##_startCounter(NAME* vTimer);                               \
+    COUNTER_T NAME##_stopCounter(NAME* vTimer);                                \
+    COUNTER_T NAME##_resetCounter(NAME* vTimer);                               \
+    COUNTER_T NAME##_getCounter(NAME* vTimer);                                 \
+    COUNTER_T NAME##_getCounterReloadValue(NAME* vTimer);                      \
+    bool NAME##_getOverflow(NAME* vTimer);                                     \
+    bool NAME##_getOverOverflow(NAME* vTimer);                                 \
+    bool NAME##_getCounterActive(NAME* vTimer);                                \
+    bool NAME##_clearOverOverflow(NAME* vTimer);
+
+
+#define PIU_VTIMER_DEFINE(NAME, COUNTER_T)                                     \
+    NAME* NAME##_construct(NAME* vTimer,                                       \
+                           COUNTER_T counterReloadValue,                       \
+                           piu_VTMode timerMode,                               \
+                           void (*callbackFunc)(void))                         \
+    {                                                                          \
+        vTimer->callback = callbackFunc;                                       \
+                                                                               \
+        vTimer->counterReloadValue = counterReloadValue;                       \
+        vTimer->counter            = 0;                                        \
+                                                                               \
+        vTimer->timerMode = (uint8_t)timerMode;                                \
+                                                                               \
+        vTimer->flag_overflow      = false;                                    \
+        vTimer->flag_overOverflow  = false;                                    \
+        vTimer->flag_counterActive = false;                                    \
+                                                                               \
+        return vTimer;                                                         \
+    }                                                                          \
+                                                                               \
+    void NAME##_tick(NAME* vTimer)                                             \
+    {                                                                          \
+        /* only tick if counter is active */                                   \
+        if (!vTimer->flag_counterActive)                                       \
+            ;                                                                  \
+        else if (vTimer->counter >= vTimer->counterReloadValue)                \
+        {                                                                      \
+            if (vTimer->flag_overflow)                                         \
+            {                                                                  \
+                vTimer->flag_overOverflow = true;                              \
+            }                                                                  \
+            vTimer->flag_overflow = true;                                      \
+                                                                               \
+            vTimer->flag_counterActive =                                       \
+                (vTimer->timerMode != piu_VTMode_OneShot);                     \
+            vTimer->counter = 0;                                               \
+                                                                               \
+            if (vTimer->callback != NULL)                                      \
+            {                                                                  \
+                vTimer->callback();                                            \
+            }                                                                  \
+        }                                                                      \
+        else                                                                   \
+        {                                                                      \
+            ++(vTimer->counter);                                               \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    COUNTER_T NAME##_setCounterReloadValue(NAME* vTimer,                       \
+                                           COUNTER_T counterReloadValue)       \
+    {                                                                          \
+        return vTimer->counterReloadValue = counterReloadValue;                \
+    }                                                                          \
+                                                                               \
+    piu_VTMode NAME##_setTimerMode(NAME* vTimer, piu_VTMode timerMode)         \
+    {                                                                          \
+        vTimer->timerMode = (uint8_t)timerMode;                                \
+        return timerMode;                                                      \
+    }                                                                          \
+                                                                               \
+    void NAME##_setCallback(NAME* vTimer, void (*callbackFunc)(void))          \
+    {                                                                          \
+        if (!vTimer->flag_counterActive)                                       \
+        {                                                                      \
+            vTimer->callback = callbackFunc;                                   \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    COUNTER_T NAME##_startCounter(NAME* vTimer)                                \
+    {                                                                          \
+        COUNTER_T counter          = vTimer->counter;                          \
+        vTimer->flag_counterActive = true;                                     \
+        return counter;                                                        \
+    }                                                                          \
+                                                                               \
+    COUNTER_T NAME##_stopCounter(NAME* vTimer)                                 \
+    {                                                                          \
+        vTimer->flag_counterActive = false;                                    \
+        return vTimer->counter;                                                \
+    }                                                                          \
+                                                                               \
+    COUNTER_T NAME##_resetCounter(NAME* vTimer)                                \
+    {                                                                          \
+        return vTimer->counter = 0;                                            \
+    }                                                                          \
+                                                                               \
+    COUNTER_T NAME##_getCounter(NAME* vTimer) { return vTimer->counter; }      \
+                                                                               \
+    COUNTER_T NAME##_getCounterReloadValue(NAME* vTimer)                       \
+    {                                                                          \
+        return vTimer->counterReloadValue;                                     \
+    }                                                                          \
+                                                                               \
+    bool NAME##_getOverflow(NAME* vTimer)                                      \
+    {                                                                          \
+        bool flag             = vTimer->flag_overflow;                         \
+        vTimer->flag_overflow = false;                                         \
+        return flag;                                                           \
+    }                                                                          \
+                                                                               \
+    bool NAME##_getOverOverflow(NAME* vTimer)                                  \
+    {                                                                          \
+        return vTimer->flag_overOverflow;                                      \
+    }                                                                          \
+                                                                               \
+    bool NAME##_getCounterActive(NAME* vTimer)                                 \
+    {                                                                          \
+        return vTimer->flag_counterActive;                                     \
+    }                                                                          \
+                                                                               \
+    bool NAME##_clearOverOverflow(NAME* vTimer)                                \
+    {                                                                          \
+        bool flag                 = vTimer->flag_overOverflow;                 \
+        vTimer->flag_overOverflow = false;                                     \
+        return flag;                                                           \
+    }
+
+
+#endif    // PIU_VTIMER_TEMPLATE_H
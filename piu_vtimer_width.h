@@ -0,0 +1,86 @@
+//
+// Created by YthanZhang on 2026/10/19.
+//
+/*******************************************************************************
+ * Copyright 2021 Ythan(Ethan) Zhang
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *******************************************************************************
+ * This software component is licensed by Ythan Zhang under the
+ *                           BSD-2-Clause license.
+ * You may not use this file except in compliance with the license.
+ * You may obtain a copy of the License at: opensource.org/licenses/BSD-2-Clause
+ ******************************************************************************/
+
+
+/*******************************************************************************
+ * @file piu_vtimer_width.h
+ *
+ * Virtual timers with other counter widths, generated from the same
+ * implementation as <b>piu_VTimer</b> (16 bits counter): @n
+ *  - <b>piu_VTimer8</b>, 8 bits counter, smallest struct for 8 bits targets @n
+ *  - <b>piu_VTimer32</b>, 32 bits counter, about 71 minutes at 1us tick @n
+ *  - <b>piu_VTimer64</b>, 64 bits counter, no practical period limit @n
+ *
+ * Every function of <b>piu_VTimer</b> exists for each width with the same
+ * semantics, only the prefix and the counter type differ, e.g.
+ * <b>piu_VTimer32_tick</b>, <b>piu_VTimer32_getCounter</b>. See piu_vtimer.h
+ * for the documentation of each function.
+ *
+ * @note <b>PIU_VTIMER_MAKE</b> can be used to initialize any of these types
+ *
+ * @example
+ * @code
+ *  // 10 seconds period with a 1us tick, without chaining timers
+ *  piu_VTimer32 longTimer =
+ *      PIU_VTIMER_MAKE(10000000 - 1, piu_VTMode_Continuous, onTimeout);
+ *  piu_VTimer32_startCounter(&longTimer);
+ * @endcode
+ */
+
+
+#ifndef PIU_VTIMER_WIDTH_H
+#define PIU_VTIMER_WIDTH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+#include <stdint.h>
+
+#include "piu_vtimer.h"
+#include "piu_vtimer_template.h"
+
+
+PIU_VTIMER_DECLARE(piu_VTimer8, uint8_t)
+
+PIU_VTIMER_DECLARE(piu_VTimer32, uint32_t)
+
+PIU_VTIMER_DECLARE(piu_VTimer64, uint64_t)
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif    // PIU_VTIMER_WIDTH_H